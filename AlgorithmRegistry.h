@@ -0,0 +1,148 @@
+#pragma once
+/**
+* AlgorithmRegistry.h
+* @author: Kevin German
+**/
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include "sort.h"
+#include "SortingDataArray.h"
+
+/**
+* @brief run time options of a registered algorithm
+**/
+struct SortOptions
+{
+	int maxThreads = 0;	//used by parallel algorithms only
+	sort::StopToken stop;	//checked by algorithms with stop token support
+	sort::ScratchArena* scratch = nullptr;	//scratch memory of the executor, reused across sorts. nullptr: algorithms allocate their own
+};
+
+/**
+* @brief entry of the algorithm registry. Everything that lists or runs algorithms (dispatcher, key bindings, help, benchmarks) iterates
+* the registry, a new algorithm only needs a new entry in algorithms[]
+**/
+struct AlgorithmInfo
+{
+	using DataSort = void (*)(SortingDataArray::iterator begin, SortingDataArray::iterator end, const SortOptions& options);
+	using KeySort = void (*)(std::vector<int>::iterator begin, std::vector<int>::iterator end, const SortOptions& options);
+
+	sort::SortingAlgorithm id;
+	const char* name;	//display name and name in scripts
+	char key;	//key binding (SDL keycode of a digit or lower case letter), '\0' if none
+	bool stable;
+	bool parallel;	//uses SortOptions::maxThreads
+	bool scratch;	//uses SortOptions::scratch, at most one element per sorted element
+	const char* complexity;	//average runtime
+	DataSort sortData;	//visualized data
+	KeySort sortKeys;	//plain keys without instrumentation (benchmarks)
+};
+
+/**
+* @brief creates a registry entry. sort is a captureless generic lambda (begin, end, options), it is instantiated for both the visualized data
+* and plain keys
+**/
+template <typename F>
+constexpr AlgorithmInfo make_algorithm(const sort::SortingAlgorithm id, const char* name, const char key, const bool stable, const bool parallel, const bool scratch,
+	const char* complexity, F sort)
+{
+	return { id, name, key, stable, parallel, scratch, complexity, sort, sort };
+}
+
+/**
+* @brief all available algorithms, in the order of the help output
+**/
+static constexpr AlgorithmInfo algorithms[] =
+{
+	make_algorithm(sort::SortingAlgorithm::stdsort, "std::sort", '1', false, false, false, "O(n log n)",
+		[](auto begin, auto end, const SortOptions&) { std::sort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::bubblesort, "bubblesort", '2', true, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::bubblesort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::bubblesortrc, "bubblesort recursivly", '3', true, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::bubblesort_rc(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::insertionsort, "insertionsort", '4', true, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::insertionsort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::insertionsortbinsearch, "insertionsort with binary search", '5', true, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::insertionsort_binsearch(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::selectionsort, "selectionsort", '6', false, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::selectionsort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::gnomesort, "gnomesort", '7', true, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::gnomesort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::gnomesort2, "gnomesort with jump", '8', true, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::gnomesort2(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::cyclesort, "cyclesort", '9', false, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::cyclesort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::shellsort, "shellsort", 'q', false, false, false, "O(n^1.3)",
+		[](auto begin, auto end, const SortOptions&) { sort::shellsort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::combsort, "combsort", 'w', false, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::combsort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::oddevensort, "odd-even-sort", 'e', true, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::odd_even_sort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::shakersort, "shakersort", 'r', true, false, false, "O(n^2)",
+		[](auto begin, auto end, const SortOptions&) { sort::shakersort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::radixsort, "radixsort", 't', true, false, true, "O(w n)",
+		[](auto begin, auto end, const SortOptions& options) { sort::radixsort(begin, end, options.scratch); }),
+	make_algorithm(sort::SortingAlgorithm::radixsortslow, "radixsort slow", 'z', true, false, true, "O(w n)",
+		[](auto begin, auto end, const SortOptions& options) { sort::radixsort_slow(begin, end, options.scratch); }),
+	make_algorithm(sort::SortingAlgorithm::radixsortipis, "radixsort in-place & insertionsort", 'u', false, true, false, "O(w n)",
+		[](auto begin, auto end, const SortOptions& options) { sort::radixsort_ip_is(begin, end, std::less<>(), options.maxThreads, options.stop); }),
+	make_algorithm(sort::SortingAlgorithm::bogosort, "bogosort", 'i', false, false, false, "O(n n!)",
+		[](auto begin, auto end, const SortOptions&) { sort::bogosort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::bozosort, "bozosort", 'o', false, false, false, "O(n n!)",
+		[](auto begin, auto end, const SortOptions&) { sort::bozosort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::quicksort, "quicksort", 'p', false, true, false, "O(n log n)",
+		[](auto begin, auto end, const SortOptions& options) { sort::quicksort(begin, end, std::less<>(), options.maxThreads, options.stop); }),
+	make_algorithm(sort::SortingAlgorithm::mergesort, "mergesort", 'a', true, true, true, "O(n log n)",
+		[](auto begin, auto end, const SortOptions& options) { sort::mergesort(begin, end, std::less<>(), options.maxThreads, options.stop, options.scratch); }),
+	make_algorithm(sort::SortingAlgorithm::heapsort, "heapsort", 's', false, false, false, "O(n log n)",
+		[](auto begin, auto end, const SortOptions&) { sort::heapsort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::introsort, "introsort", 'd', false, true, false, "O(n log n)",
+		[](auto begin, auto end, const SortOptions& options) { sort::introsort(begin, end, std::less<>(), options.maxThreads, options.stop); }),
+	make_algorithm(sort::SortingAlgorithm::stdstablesort, "std::stable_sort", 'f', true, false, false, "O(n log n)",
+		[](auto begin, auto end, const SortOptions&) { std::stable_sort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::powersort, "powersort", 'g', true, false, false, "O(n log n), O(n) presorted",
+		[](auto begin, auto end, const SortOptions&) { sort::powersort(begin, end, std::less<>()); }),
+	make_algorithm(sort::SortingAlgorithm::samplesort, "samplesort", 'h', false, true, false, "O(n log n)",
+		[](auto begin, auto end, const SortOptions& options) { sort::samplesort(begin, end, std::less<>(), options.maxThreads, options.stop); }),
+	make_algorithm(sort::SortingAlgorithm::multiwaymergesort, "multiway mergesort", 'j', true, true, false, "O(n log n)",
+		[](auto begin, auto end, const SortOptions& options) { sort::multiway_mergesort(begin, end, std::less<>(), options.maxThreads, options.stop); }),
+	make_algorithm(sort::SortingAlgorithm::countingsort, "countingsort", 'k', true, true, true, "O(n + k)",
+		[](auto begin, auto end, const SortOptions& options) { sort::countingsort(begin, end, std::less<>(), options.maxThreads, options.stop, options.scratch); })
+};
+
+/**
+* @brief registry lookup by id
+* @return entry or nullptr
+**/
+constexpr const AlgorithmInfo* find_algorithm(const sort::SortingAlgorithm id)
+{
+	for (const auto& algorithm : algorithms)
+		if (algorithm.id == id)
+			return &algorithm;
+	return nullptr;
+}
+
+/**
+* @brief registry lookup by key binding
+* @return entry or nullptr
+**/
+constexpr const AlgorithmInfo* find_algorithm_by_key(const int key)
+{
+	for (const auto& algorithm : algorithms)
+		if (algorithm.key != '\0' && algorithm.key == key)
+			return &algorithm;
+	return nullptr;
+}
+
+/**
+* @brief registry lookup by name
+* @return entry or nullptr
+**/
+inline const AlgorithmInfo* find_algorithm_by_name(const char* name)
+{
+	for (const auto& algorithm : algorithms)
+		if (std::strcmp(algorithm.name, name) == 0)
+			return &algorithm;
+	return nullptr;
+}
@@ -0,0 +1,479 @@
+/**
+* Benchmark.cpp
+* @author: Kevin German
+**/
+#include "Benchmark.h"
+#include "AlgorithmRegistry.h"
+#include "PerfCounters.h"
+#include "settings.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <limits>
+#include <algorithm>
+
+namespace
+{
+	const std::string distributions[] = { "uniform", "zipf", "sorted", "reversed", "fewunique", "nearlysorted" };
+
+	/**
+	* @brief one command of a script
+	**/
+	struct Step
+	{
+		enum class Type { generate, sort, verify } type;
+		std::string text;	//command as written in the script, used in the report
+		std::string distribution;
+		size_t n = 0;
+		unsigned seed = 0;
+		const AlgorithmInfo* algorithm = nullptr;
+		int threads = defaultMaxThreads;
+	};
+
+	/**
+	* @brief commands which are repeated count times
+	**/
+	struct Block
+	{
+		std::vector<size_t> steps;	//indices into the step list
+		int count = 1;
+	};
+
+	/**
+	* @brief measurements of one step over all repetitions
+	**/
+	struct StepResult
+	{
+		std::vector<double> seconds;
+		std::vector<double> counters[PerfCounters::counterCount];	//hardware counters, empty if unavailable
+		size_t verified = 0;
+		size_t failed = 0;
+	};
+
+	/**
+	* @brief mean time of repeats sorts of a copy of input
+	**/
+	Statistics time_sort(const AlgorithmInfo& algorithm, const std::vector<int>& input, const int threads, const int repeats)
+	{
+		std::vector<double> seconds;
+		std::vector<int> data;
+		sort::ScratchArena scratch;
+		if (algorithm.scratch)
+			scratch.reserve(input.size() * sizeof(int));
+		for (auto r = 0; r < repeats; ++r)
+		{
+			data = input;
+			const auto start = std::chrono::high_resolution_clock::now();
+			algorithm.sortKeys(data.begin(), data.end(), { threads, sort::StopToken(), &scratch });
+			const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+			seconds.push_back(elapsed.count());
+		}
+		return compute_statistics(seconds);
+	}
+
+	/**
+	* @brief two sided 97.5% quantile of the student t distribution
+	**/
+	double t_quantile(const size_t degreesOfFreedom)
+	{
+		static constexpr double table[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+			2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+		if (degreesOfFreedom == 0)
+			return 0.0;
+		if (degreesOfFreedom <= sizeof(table) / sizeof(table[0]))
+			return table[degreesOfFreedom - 1];
+		return degreesOfFreedom <= 60 ? 2.000 : (degreesOfFreedom <= 120 ? 1.980 : 1.960);
+	}
+
+	/**
+	* @brief parses a count like 10000, 1e7 or 2.5e6
+	* @return false if text is no positive number
+	**/
+	bool parse_count(const std::string& text, size_t& count)
+	{
+		try
+		{
+			size_t used = 0;
+			const auto value = std::stod(text, &used);
+			if (used != text.size() || value < 1.0)
+				return false;
+			count = static_cast<size_t>(value + 0.5);
+			return true;
+		}
+		catch (std::exception&)
+		{
+			return false;
+		}
+	}
+
+	/**
+	* @brief parses a random seed (unsigned decimal integer)
+	* @return false if text is no number in the range of unsigned
+	**/
+	bool parse_seed(const std::string& text, unsigned& seed)
+	{
+		if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos)
+			return false;
+		try
+		{
+			const auto value = std::stoull(text);
+			if (value > std::numeric_limits<unsigned>::max())
+				return false;
+			seed = static_cast<unsigned>(value);
+			return true;
+		}
+		catch (std::exception&)
+		{
+			return false;
+		}
+	}
+
+	/**
+	* @brief parses one command
+	* @return false and an error message if the command is invalid
+	**/
+	bool parse_step(const std::string& text, Step& step, int& repeat, std::string& error)
+	{
+		std::istringstream stream(text);
+		std::vector<std::string> tokens;
+		for (std::string token; stream >> token;)
+			tokens.push_back(token);
+		step.text = text.substr(text.find_first_not_of(" \t"));
+		step.text = step.text.substr(0, step.text.find_last_not_of(" \t\r") + 1);
+
+		const auto& command = tokens[0];
+		if (command == "generate")
+		{
+			step.type = Step::Type::generate;
+			const std::string usage = "usage: generate <uniform|zipf|sorted|reversed|fewunique|nearlysorted> <n> [seed=<seed>]";
+			if (tokens.size() < 3 || std::find(std::begin(distributions), std::end(distributions), tokens[1]) == std::end(distributions) || !parse_count(tokens[2], step.n))
+			{
+				error = usage;
+				return false;
+			}
+			step.distribution = tokens[1];
+			for (size_t i = 3; i < tokens.size(); ++i)
+			{
+				if (tokens[i].compare(0, 5, "seed=") != 0)
+				{
+					error = "unknown option " + tokens[i];
+					return false;
+				}
+				if (!parse_seed(tokens[i].substr(5), step.seed))
+				{
+					error = usage;
+					return false;
+				}
+			}
+			return true;
+		}
+		if (command == "sort")
+		{
+			step.type = Step::Type::sort;
+			//algorithm names may contain spaces, everything which is no option belongs to the name
+			std::string name;
+			for (size_t i = 1; i < tokens.size(); ++i)
+			{
+				if (tokens[i].compare(0, 8, "threads=") == 0)
+					step.threads = std::atoi(tokens[i].c_str() + 8);
+				else
+					name += (name.empty() ? "" : " ") + tokens[i];
+			}
+			step.algorithm = find_algorithm_by_name(name.c_str());
+			if (!step.algorithm)
+			{
+				error = "unknown algorithm \"" + name + "\"";
+				return false;
+			}
+			return true;
+		}
+		if (command == "verify" && tokens.size() == 1)
+		{
+			step.type = Step::Type::verify;
+			return true;
+		}
+		if (command == "repeat")
+		{
+			size_t count = 0;
+			if (tokens.size() != 2 || !parse_count(tokens[1], count))
+			{
+				error = "usage: repeat <count>";
+				return false;
+			}
+			repeat = static_cast<int>(count);
+			return true;
+		}
+		error = "unknown command \"" + command + "\"";
+		return false;
+	}
+}
+
+Statistics compute_statistics(const std::vector<double>& samples)
+{
+	Statistics statistics;
+	statistics.runs = samples.size();
+	if (samples.empty())
+		return statistics;
+
+	for (const auto sample : samples)
+		statistics.mean += sample;
+	statistics.mean /= static_cast<double>(samples.size());
+	if (samples.size() > 1)
+	{
+		auto sum = 0.0;
+		for (const auto sample : samples)
+			sum += (sample - statistics.mean) * (sample - statistics.mean);
+		statistics.stddev = std::sqrt(sum / static_cast<double>(samples.size() - 1));
+	}
+	const auto halfWidth = t_quantile(samples.size() - 1) * statistics.stddev / std::sqrt(static_cast<double>(samples.size()));
+	statistics.ciLow = statistics.mean - halfWidth;
+	statistics.ciHigh = statistics.mean + halfWidth;
+	return statistics;
+}
+
+bool generate_keys(const std::string& distribution, const size_t n, const unsigned seed, std::vector<int>& keys)
+{
+	std::mt19937 gen(seed);
+	keys.resize(n);
+	if (distribution == "uniform")
+	{
+		std::uniform_int_distribution<int> dist(0, std::numeric_limits<int>::max());
+		for (auto& key : keys)
+			key = dist(gen);
+	}
+	else if (distribution == "zipf")
+	{
+		//zipf (s = 1) over 2^16 distinct keys, key k has a probability proportional to 1/k
+		std::vector<double> weights(1 << 16);
+		for (size_t k = 0; k < weights.size(); ++k)
+			weights[k] = 1.0 / static_cast<double>(k + 1);
+		std::discrete_distribution<int> dist(weights.begin(), weights.end());
+		for (auto& key : keys)
+			key = dist(gen);
+	}
+	else if (distribution == "sorted" || distribution == "reversed")
+	{
+		for (size_t i = 0; i < n; ++i)
+			keys[i] = static_cast<int>(distribution == "sorted" ? i : n - i);
+	}
+	else if (distribution == "fewunique")
+	{
+		std::uniform_int_distribution<int> dist(0, 15);
+		for (auto& key : keys)
+			key = dist(gen);
+	}
+	else if (distribution == "nearlysorted")
+	{
+		//sorted with 1% random swaps
+		for (size_t i = 0; i < n; ++i)
+			keys[i] = static_cast<int>(i);
+		if (n > 1)
+		{
+			std::uniform_int_distribution<size_t> dist(0, n - 1);
+			for (size_t i = 0; i < n / 100; ++i)
+				std::swap(keys[dist(gen)], keys[dist(gen)]);
+		}
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+int run_script(const std::string& script, const std::string& reportFile)
+{
+	//----parse----
+	std::vector<Step> steps;
+	std::vector<Block> blocks(1);
+	std::istringstream lines(script);
+	for (std::string line; std::getline(lines, line);)
+	{
+		line = line.substr(0, line.find('#'));
+		std::istringstream commands(line);
+		for (std::string text; std::getline(commands, text, ';');)
+		{
+			if (text.find_first_not_of(" \t\r") == std::string::npos)
+				continue;
+			Step step;
+			auto repeat = 0;
+			std::string error;
+			if (!parse_step(text, step, repeat, error))
+			{
+				std::cout << "Script error in \"" << text << "\": " << error << "\n";
+				return -1;
+			}
+			if (repeat != 0)
+			{
+				blocks.back().count = repeat;
+				blocks.emplace_back();
+				continue;
+			}
+			blocks.back().steps.push_back(steps.size());
+			steps.push_back(step);
+		}
+	}
+	if (steps.empty() || steps.front().type != Step::Type::generate)
+	{
+		std::cout << "Script error: the script has to start with generate\n";
+		return -1;
+	}
+
+	//----run----
+	std::vector<StepResult> results(steps.size());
+	PerfCounters counters;
+	if (!counters.available())
+		std::cout << "Hardware performance counters are not available, only times are reported\n";
+	std::vector<int> input, data;
+	sort::ScratchArena scratch;	//reused by all sorts, sized before the timer for the largest input
+	const Step* generated = nullptr;	//generate step which produced input
+	auto sorted = false;	//data holds the result of a sort
+	for (const auto& block : blocks)
+	{
+		for (auto run = 0; run < block.count; ++run)
+		{
+			for (const auto s : block.steps)
+			{
+				const auto& step = steps[s];
+				auto& result = results[s];
+				switch (step.type)
+				{
+				case Step::Type::generate:
+					//repeated generates with the same parameters produce the same input
+					if (!generated || generated->distribution != step.distribution || generated->n != step.n || generated->seed != step.seed)
+						generate_keys(step.distribution, step.n, step.seed, input);
+					generated = &step;
+					sorted = false;
+					break;
+				case Step::Type::sort:
+				{
+					data = input;
+					if (step.algorithm->scratch)
+						scratch.reserve(input.size() * sizeof(int));
+					counters.start();
+					const auto start = std::chrono::high_resolution_clock::now();
+					step.algorithm->sortKeys(data.begin(), data.end(), { step.threads, sort::StopToken(), &scratch });
+					const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+					counters.stop();
+					result.seconds.push_back(elapsed.count());
+					for (auto c = 0; c < PerfCounters::counterCount; ++c)
+						if (counters.valid(static_cast<PerfCounters::Counter>(c)))
+							result.counters[c].push_back(counters.value(static_cast<PerfCounters::Counter>(c)));
+					sorted = true;
+					std::cout << step.text << ":\t" << elapsed.count() << " s\n";
+					break;
+				}
+				case Step::Type::verify:
+					if (sorted && sort::verifiy_sort_order(data.begin(), data.end(), std::less<>()))
+						++result.verified;
+					else
+						++result.failed;
+					break;
+				}
+			}
+		}
+	}
+
+	//----report----
+	std::ofstream file;
+	if (!reportFile.empty())
+	{
+		file.open(reportFile);
+		if (!file)
+		{
+			std::cout << "Error: could not create " << reportFile << "\n";
+			return -1;
+		}
+	}
+	auto& report = reportFile.empty() ? std::cout : file;
+	report << "# SortVisualization benchmark report, hardware threads: " << std::thread::hardware_concurrency() << "\n"
+		<< "step\tcommand\truns\tmean [s]\tstddev [s]\tci95 low [s]\tci95 high [s]\tverified\tfailed";
+	for (auto c = 0; c < PerfCounters::counterCount; ++c)
+		report << "\t" << PerfCounters::name(static_cast<PerfCounters::Counter>(c));
+	report << "\tIPC\n";
+	auto failed = false;
+	for (size_t s = 0; s < steps.size(); ++s)
+	{
+		if (steps[s].type == Step::Type::generate)
+			continue;
+		const auto& result = results[s];
+		const auto statistics = compute_statistics(result.seconds);
+		report << s << "\t" << steps[s].text << "\t" << std::max(statistics.runs, result.verified + result.failed) << "\t";
+		if (steps[s].type == Step::Type::sort)
+			report << statistics.mean << "\t" << statistics.stddev << "\t" << statistics.ciLow << "\t" << statistics.ciHigh << "\t-\t-";
+		else
+			report << "-\t-\t-\t-\t" << result.verified << "\t" << result.failed;
+		//mean of the hardware counters
+		for (const auto& counter : result.counters)
+			report << "\t" << (counter.empty() ? "-" : std::to_string(compute_statistics(counter).mean));
+		const auto& cycles = result.counters[PerfCounters::cycles];
+		const auto& instructions = result.counters[PerfCounters::instructions];
+		if (!cycles.empty() && !instructions.empty() && compute_statistics(cycles).mean > 0.0)
+			report << "\t" << compute_statistics(instructions).mean / compute_statistics(cycles).mean << "\n";
+		else
+			report << "\t-\n";
+		failed = failed || result.failed != 0;
+	}
+	report.flush();
+	return failed || !report ? -1 : 0;
+}
+
+int run_scaling(const ScalingSettings& settings, const std::string& csvFile)
+{
+	if (std::find(std::begin(distributions), std::end(distributions), settings.distribution) == std::end(distributions))
+	{
+		std::cout << "Error: unknown distribution " << settings.distribution << "\n";
+		return -1;
+	}
+	std::ofstream file;
+	if (!csvFile.empty())
+	{
+		file.open(csvFile);
+		if (!file)
+		{
+			std::cout << "Error: could not create " << csvFile << "\n";
+			return -1;
+		}
+	}
+	auto& csv = csvFile.empty() ? std::cout : file;
+	const auto maxThreads = settings.maxThreads > 0 ? settings.maxThreads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	const auto repeats = std::max(settings.repeats, 1);
+
+	csv << "mode,algorithm,threads,n,mean_s,stddev_s,speedup,efficiency,karp_flatt\n";
+	std::vector<int> input;
+	for (const auto& algorithm : algorithms)
+	{
+		if (!algorithm.parallel)
+			continue;
+		for (const auto weak : { false, true })
+		{
+			const auto mode = weak ? "weak" : "strong";
+			auto t1 = 0.0;
+			for (auto threads = 1; threads <= maxThreads; ++threads)
+			{
+				const auto n = weak ? settings.n * static_cast<size_t>(threads) : settings.n;
+				if (input.size() != n)
+					generate_keys(settings.distribution, n, settings.seed, input);
+				const auto statistics = time_sort(algorithm, input, threads, repeats);
+				if (threads == 1)
+					t1 = statistics.mean;
+
+				const auto p = static_cast<double>(threads);
+				const auto speedup = statistics.mean > 0.0 ? (weak ? p : 1.0) * t1 / statistics.mean : 0.0;
+				csv << mode << ",\"" << algorithm.name << "\"," << threads << "," << n << "," << statistics.mean << "," << statistics.stddev << ","
+					<< speedup << "," << speedup / p << ",";
+				//serial fraction is undefined for a single thread
+				if (threads > 1 && speedup > 0.0)
+					csv << (1.0 / speedup - 1.0 / p) / (1.0 - 1.0 / p);
+				csv << "\n";
+				std::cout << mode << " scaling " << algorithm.name << ", " << threads << " threads, n = " << n << ":\t" << statistics.mean << " s, speedup " << speedup << "\n";
+			}
+		}
+	}
+	csv.flush();
+	return csv ? 0 : -1;
+}
@@ -0,0 +1,73 @@
+#pragma once
+/**
+* Benchmark.h
+* @author: Kevin German
+**/
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+* @brief summary of repeated measurements
+**/
+struct Statistics
+{
+	size_t runs = 0;
+	double mean = 0.0;
+	double stddev = 0.0;	//sample standard deviation
+	double ciLow = 0.0;	//95% confidence interval of the mean (student t)
+	double ciHigh = 0.0;
+};
+
+/**
+* @brief computes mean, standard deviation and the 95% confidence interval of the mean
+* @param samples: measurements
+* @return statistics of samples
+**/
+Statistics compute_statistics(const std::vector<double>& samples);
+
+/**
+* @brief fills keys with n generated keys
+* @param distribution: uniform, zipf, sorted, reversed, fewunique or nearlysorted
+* @param n: number of keys
+* @param seed: seed of the random number generator
+* @param keys: output
+* @return false if the distribution is unknown
+**/
+bool generate_keys(const std::string& distribution, size_t n, unsigned seed, std::vector<int>& keys);
+
+/**
+* @brief runs a benchmark script unattended and writes an aggregated report. Commands are separated by ';' or new lines, '#' starts a comment:
+*   generate <distribution> <n> [seed=<seed>]	new input, n may be written as 1e7
+*   sort <algorithm name> [threads=<threads>]	sorts a copy of the input with a registered algorithm (plain int keys, no delays)
+*   verify	checks the order of the last sorted data
+*   repeat <count>	runs all commands since the previous repeat count times
+* Example: generate zipf 1e7; sort introsort threads=8; verify; repeat 10
+* @param script: script text
+* @param reportFile: path of the report, empty for std::cout
+* @return 0 on success, -1 if the script is invalid or a verification failed
+**/
+int run_script(const std::string& script, const std::string& reportFile);
+
+/**
+* @brief settings of the scaling sweep
+**/
+struct ScalingSettings
+{
+	size_t n = 10000000;	//elements of the strong scaling runs and per thread of the weak scaling runs
+	int maxThreads = 0;	//sweep 1..maxThreads. 0: hardware threads
+	int repeats = 5;	//runs per measurement point
+	std::string distribution = "uniform";
+	unsigned seed = 0;
+};
+
+/**
+* @brief measures how the parallel algorithms of the registry scale with their maxThreads knob.
+* Strong scaling sorts n elements with 1..maxThreads threads, weak scaling sorts n * threads elements.
+* Reports speedup S = T1 / Tp (weak: scaled speedup p * T1 / Tp), parallel efficiency E = S / p and
+* the Karp-Flatt serial fraction e = (1 / S - 1 / p) / (1 - 1 / p)
+* @param settings: problem size, thread range, repetitions and input distribution
+* @param csvFile: path of the csv file, empty for std::cout
+* @return 0 on success, -1 on error
+**/
+int run_scaling(const ScalingSettings& settings, const std::string& csvFile);
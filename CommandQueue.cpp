@@ -0,0 +1,32 @@
+/**
+* CommandQueue.cpp
+* @author: Kevin German
+**/
+#include "CommandQueue.h"
+#include "SortControl.h"
+
+void CommandQueue::push(const SortCommand& command)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCommands.push_back(command);
+	}
+	mCondition.notify_one();
+}
+
+void CommandQueue::clear()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCommands.clear();
+	cancel_sort();
+}
+
+SortCommand CommandQueue::pop()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mCondition.wait(lock, [this]() { return !mCommands.empty(); });
+	const auto command = mCommands.front();
+	mCommands.pop_front();
+	reset_sort_control();
+	return command;
+}
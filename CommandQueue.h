@@ -0,0 +1,58 @@
+#pragma once
+/**
+* CommandQueue.h
+* @author: Kevin German
+**/
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "sort.h"
+
+/**
+* @brief work item of the sort executor (thread_sorting)
+**/
+struct SortCommand
+{
+	enum class Type
+	{
+		sort,	//run algorithm
+		init,	//random init data
+		inverse,	//reverse order
+		verify,	//verify order
+		quit	//stop the executor
+	};
+
+	Type type = Type::sort;
+	sort::SortingAlgorithm algorithm = sort::SortingAlgorithm::none;
+};
+
+/**
+* @brief queue from the event loop to the sort executor. Commands run one after another in the order they were queued
+**/
+class CommandQueue
+{
+	std::deque<SortCommand> mCommands;
+	std::mutex mMutex;
+	std::condition_variable mCondition;	//notified when a command was queued
+
+public:
+	/**
+	* @brief appends command. It runs after the running and all queued commands
+	* @param command: command to append
+	* @return void
+	**/
+	void push(const SortCommand& command);
+
+	/**
+	* @brief cancels the running sort and removes all queued commands
+	* @return void
+	**/
+	void clear();
+
+	/**
+	* @brief waits for the next command and removes it from the queue. The cancel and pause state of the sort control is reset
+	* before the command is returned, a cancel that is requested afterwards (clear) always reaches the returned command
+	* @return next command
+	**/
+	SortCommand pop();
+};
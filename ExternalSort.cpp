@@ -0,0 +1,276 @@
+/**
+* ExternalSort.cpp
+* @author: Kevin German
+**/
+#include "ExternalSort.h"
+#include "sort.h"
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <future>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+	using Key = int;
+
+	/**
+	* @brief reads up to count keys from file
+	* @return number of keys read
+	**/
+	size_t read_keys(std::ifstream& file, Key* data, const size_t count)
+	{
+		file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(Key)));
+		return static_cast<size_t>(file.gcount()) / sizeof(Key);
+	}
+
+	/**
+	* @brief writes count keys to a new file
+	* @return true on success
+	**/
+	bool write_run(const std::filesystem::path& path, const Key* data, const size_t count)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(Key)));
+		file.close();
+		return !file.fail();
+	}
+
+	/**
+	* @brief sequential reader of a run file. The next block is prefetched asynchronously while the current one is consumed
+	**/
+	class RunReader
+	{
+		std::unique_ptr<std::ifstream> mFile;	//on the heap, so a pending prefetch survives moving the reader
+		std::vector<Key> mBlock, mNextBlock;
+		size_t mSize{ 0 };	//number of valid keys in mBlock
+		size_t mPos{ 0 };	//position of the next key in mBlock
+		std::future<size_t> mPrefetch;
+
+		void prefetch()
+		{
+			mPrefetch = std::async(std::launch::async, read_keys, std::ref(*mFile), mNextBlock.data(), mNextBlock.size());
+		}
+
+	public:
+		RunReader(const std::filesystem::path& path, const size_t blockSize)
+			: mFile(std::make_unique<std::ifstream>(path, std::ios::binary)), mBlock(blockSize), mNextBlock(blockSize)
+		{
+			prefetch();
+			next();
+		}
+
+		RunReader(RunReader&&) = default;
+		RunReader& operator=(RunReader&&) = default;
+
+		~RunReader()
+		{
+			if (mPrefetch.valid())
+				mPrefetch.wait();
+		}
+
+		/**
+		* @brief check if the run is exhausted
+		* @return true if there are no keys left
+		**/
+		bool empty() const { return mPos == mSize; }
+
+		/**
+		* @return current key. run must not be empty
+		**/
+		Key front() const { return mBlock[mPos]; }
+
+		/**
+		* @brief advance to the next key
+		* @return void
+		**/
+		void next()
+		{
+			if (mPos + 1 < mSize)
+			{
+				++mPos;
+				return;
+			}
+			mSize = mPrefetch.valid() ? mPrefetch.get() : 0;
+			mPos = 0;
+			std::swap(mBlock, mNextBlock);
+			if (mSize != 0)
+				prefetch();
+		}
+	};
+
+	/**
+	* @brief sequential writer. Full blocks are written asynchronously while the next block is filled
+	**/
+	class BlockWriter
+	{
+		std::ofstream mFile;
+		std::vector<Key> mBlock, mWriteBlock;
+		std::future<void> mPending;
+		size_t mBlockSize;
+
+	public:
+		BlockWriter(const std::filesystem::path& path, const size_t blockSize)
+			: mFile(path, std::ios::binary | std::ios::trunc), mBlockSize(blockSize)
+		{
+			mBlock.reserve(blockSize);
+			mWriteBlock.reserve(blockSize);
+		}
+
+		~BlockWriter()
+		{
+			if (mPending.valid())
+				mPending.wait();
+		}
+
+		/**
+		* @return true if the file could be opened and all writes succeeded so far
+		**/
+		bool good() const { return static_cast<bool>(mFile); }
+
+		void push(const Key key)
+		{
+			mBlock.push_back(key);
+			if (mBlock.size() == mBlockSize)
+				flush();
+		}
+
+		void flush()
+		{
+			if (mPending.valid())
+				mPending.get();
+			std::swap(mBlock, mWriteBlock);
+			mBlock.clear();
+			mPending = std::async(std::launch::async, [this]()
+			{
+				mFile.write(reinterpret_cast<const char*>(mWriteBlock.data()), static_cast<std::streamsize>(mWriteBlock.size() * sizeof(Key)));
+			});
+		}
+
+		/**
+		* @brief writes the remaining keys and waits for all pending writes
+		* @return true if all writes succeeded
+		**/
+		bool close()
+		{
+			flush();
+			mPending.get();
+			mFile.close();
+			return !mFile.fail();
+		}
+	};
+
+	/**
+	* @brief merges the given runs into outputFile with one pass over the data
+	* @return true on success
+	**/
+	bool merge_runs(const std::vector<std::filesystem::path>& runFiles, const std::filesystem::path& outputFile, const size_t memoryBudget)
+	{
+		//two blocks per run (current + prefetch) and two blocks for the output
+		const auto blockSize = std::max(minExternalBlockSize, memoryBudget / (2 * (runFiles.size() + 1))) / sizeof(Key);
+		std::vector<RunReader> runs;
+		runs.reserve(runFiles.size());
+		for (const auto& runFile : runFiles)
+			runs.emplace_back(runFile, blockSize);
+
+		BlockWriter output(outputFile, blockSize);
+		if (!output.good())
+		{
+			std::cout << "Error: could not create " << outputFile << "\n";
+			return false;
+		}
+		for (sort::LoserTree<RunReader, std::less<>> tree(std::move(runs)); !tree.empty(); tree.pop())
+			output.push(tree.top().front());
+		return output.close();
+	}
+}
+
+bool sort::external_sort(const std::string& inputFile, const std::string& outputFile, const ExternalSortSettings& settings)
+{
+	namespace fs = std::filesystem;
+
+	std::error_code error;
+	const auto tempDirectory = settings.tempDirectory.empty() ? fs::temp_directory_path(error) : fs::path(settings.tempDirectory);
+	if (error || !fs::is_directory(tempDirectory, error))
+	{
+		std::cout << "Error: invalid temp directory " << tempDirectory << "\n";
+		return false;
+	}
+
+	std::ifstream input(inputFile, std::ios::binary);
+	if (!input)
+	{
+		std::cout << "Error: " << inputFile << " not found!\n";
+		return false;
+	}
+	if (fs::file_size(inputFile, error) % sizeof(Key) != 0)
+		std::cout << "Warning: size of " << inputFile << " is not a multiple of " << sizeof(Key) << " bytes. Trailing bytes are ignored\n";
+
+	//----phase 1: sorted runs. while a chunk is sorted, the next one is read and the previous one is written----
+	//three chunks share the budget. introsort sorts in place, so sorting needs no memory beyond the chunk
+	const auto chunkSize = std::max(minExternalBlockSize, settings.memoryBudget / 3) / sizeof(Key);
+	std::vector<Key> chunk(chunkSize), nextChunk(chunkSize), writtenChunk(chunkSize);
+	std::future<bool> pendingWrite;
+	std::vector<fs::path> runFiles;
+	const auto runPrefix = "sortvisualization_" + std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+	const auto removeRuns = [&runFiles]()
+	{
+		std::error_code ignored;
+		for (const auto& runFile : runFiles)
+			fs::remove(runFile, ignored);
+	};
+
+	auto size = read_keys(input, chunk.data(), chunkSize);
+	while (size != 0)
+	{
+		auto prefetch = std::async(std::launch::async, read_keys, std::ref(input), nextChunk.data(), chunkSize);
+		sort::introsort(chunk.begin(), std::next(chunk.begin(), size), std::less<>(), settings.maxThreads);
+
+		//the buffer of the previous run is reused, so its write has to be finished
+		if (pendingWrite.valid() && !pendingWrite.get())
+		{
+			std::cout << "Error: could not write run file " << runFiles.back() << "\n";
+			prefetch.wait();
+			removeRuns();
+			return false;
+		}
+		runFiles.push_back(tempDirectory / (runPrefix + "_run" + std::to_string(runFiles.size()) + ".tmp"));
+		std::swap(chunk, writtenChunk);
+		pendingWrite = std::async(std::launch::async, write_run, runFiles.back(), writtenChunk.data(), size);
+		size = prefetch.get();
+		std::swap(chunk, nextChunk);
+	}
+	if (pendingWrite.valid() && !pendingWrite.get())
+	{
+		std::cout << "Error: could not write run file " << runFiles.back() << "\n";
+		removeRuns();
+		return false;
+	}
+	chunk = std::vector<Key>();
+	nextChunk = std::vector<Key>();
+	writtenChunk = std::vector<Key>();
+	std::cout << "External sort: " << runFiles.size() << " sorted runs written to " << tempDirectory << "\n";
+
+	//----phase 2: k-way merge. if the budget does not allow blocks of minExternalBlockSize for every run, merge in several passes----
+	const auto maxFanIn = std::max<size_t>(2, settings.memoryBudget / (2 * minExternalBlockSize) - 1);
+	auto success = true;
+	for (auto pass = 0; success && runFiles.size() > maxFanIn; ++pass)
+	{
+		std::vector<fs::path> mergedRuns;
+		for (size_t first = 0; success && first < runFiles.size(); first += maxFanIn)
+		{
+			const std::vector<fs::path> group(runFiles.begin() + first, runFiles.begin() + std::min(runFiles.size(), first + maxFanIn));
+			mergedRuns.push_back(tempDirectory / (runPrefix + "_pass" + std::to_string(pass) + "_run" + std::to_string(mergedRuns.size()) + ".tmp"));
+			success = merge_runs(group, mergedRuns.back(), settings.memoryBudget);
+		}
+		removeRuns();
+		runFiles = std::move(mergedRuns);
+	}
+	if (success)
+		success = merge_runs(runFiles, outputFile, settings.memoryBudget);
+	removeRuns();
+	return success;
+}
@@ -0,0 +1,32 @@
+#pragma once
+/**
+* ExternalSort.h
+* @author: Kevin German
+**/
+#include <string>
+#include <cstddef>
+#include "settings.h"
+
+namespace sort
+{
+	/**
+	* @brief settings for sorting files which are larger than the available memory
+	**/
+	struct ExternalSortSettings
+	{
+		size_t memoryBudget{ defaultExternalMemoryBudget };	//bytes used for sorting chunks and for the merge buffers
+		std::string tempDirectory;	//directory for the sorted runs. empty: temp directory of the system
+		int maxThreads{ defaultMaxThreads };	//threads used for sorting the chunks
+	};
+
+	/**
+	* @brief sorts a binary file of 32 bit integer keys which may be larger than the memory budget. The input is read in memory sized chunks,
+	* each chunk is sorted in place with the parallel introsort and spilled to a temporary run file. The runs are merged with a loser tree afterwards.
+	* All reads and writes are large sequential blocks which are prefetched/written asynchronously and overlap with sorting.
+	* @param inputFile: path of the unsorted input file
+	* @param outputFile: path of the sorted output file
+	* @param settings: memory budget, temp directory and threads
+	* @return true if the file was sorted successfully, else false (an error message is written to std::cout)
+	**/
+	bool external_sort(const std::string& inputFile, const std::string& outputFile, const ExternalSortSettings& settings = ExternalSortSettings());
+}
@@ -0,0 +1,126 @@
+/**
+* PerfCounters.cpp
+* @author: Kevin German
+**/
+#include "PerfCounters.h"
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace
+{
+	/**
+	* @brief opens one counter for the calling thread and its future child threads, user space only
+	* @return file descriptor or -1
+	**/
+	int open_counter(const std::uint32_t type, const std::uint64_t config)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = type;
+		attr.config = config;
+		attr.disabled = 1;
+		attr.inherit = 1;	//count the worker threads of the parallel sorts as well
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+
+	constexpr std::uint64_t cache_miss(const std::uint64_t cache)
+	{
+		return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	}
+}
+
+PerfCounters::PerfCounters()
+{
+	mFile[cycles] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	mFile[instructions] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	mFile[branchMisses] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+	mFile[l1dMisses] = open_counter(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D));
+	mFile[llcMisses] = open_counter(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL));
+	mFile[tlbMisses] = open_counter(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB));
+}
+
+PerfCounters::~PerfCounters()
+{
+	for (const auto file : mFile)
+		if (file >= 0)
+			close(file);
+}
+
+void PerfCounters::start()
+{
+	for (auto c = 0; c < counterCount; ++c)
+	{
+		mValue[c] = 0.0;
+		if (mFile[c] >= 0)
+		{
+			ioctl(mFile[c], PERF_EVENT_IOC_RESET, 0);
+			ioctl(mFile[c], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+void PerfCounters::stop()
+{
+	for (auto c = 0; c < counterCount; ++c)
+	{
+		if (mFile[c] < 0)
+			continue;
+		ioctl(mFile[c], PERF_EVENT_IOC_DISABLE, 0);
+		std::uint64_t data[3] = {};	//value, time enabled, time running
+		if (read(mFile[c], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+			continue;
+		//scale if the counter was multiplexed with other events
+		mValue[c] = data[2] != 0 ? static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]) : 0.0;
+	}
+}
+#else
+PerfCounters::PerfCounters()
+{
+	for (auto& file : mFile)
+		file = -1;
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::start()
+{
+}
+
+void PerfCounters::stop()
+{
+}
+#endif
+
+bool PerfCounters::available() const
+{
+	for (const auto file : mFile)
+		if (file >= 0)
+			return true;
+	return false;
+}
+
+const char* PerfCounters::name(const Counter counter)
+{
+	static constexpr const char* names[counterCount] = { "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses", "dTLB-misses" };
+	return names[counter];
+}
+
+void PerfCounters::print(std::ostream& out) const
+{
+	for (auto c = 0; c < counterCount; ++c)
+		if (valid(static_cast<Counter>(c)))
+			out << name(static_cast<Counter>(c)) << ": " << value(static_cast<Counter>(c)) << "  ";
+	if (valid(cycles) && valid(instructions) && value(cycles) > 0.0)
+		out << "IPC: " << value(instructions) / value(cycles);
+	out << "\n";
+}
@@ -0,0 +1,72 @@
+#pragma once
+/**
+* PerfCounters.h
+* @author: Kevin German
+**/
+#include <ostream>
+
+/**
+* @brief hardware performance counters of the calling thread and all threads it starts afterwards (Linux perf_event_open).
+* Counters which are not supported by the system (other platforms, virtual machines, perf_event_paranoid) are skipped
+**/
+class PerfCounters
+{
+public:
+	enum Counter
+	{
+		cycles,
+		instructions,
+		branchMisses,
+		l1dMisses,
+		llcMisses,
+		tlbMisses,
+		counterCount
+	};
+
+	PerfCounters();
+	~PerfCounters();
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	/**
+	* @return true if at least one counter is available
+	**/
+	bool available() const;
+
+	/**
+	* @brief resets and starts all counters
+	* @return void
+	**/
+	void start();
+
+	/**
+	* @brief stops all counters and reads their values
+	* @return void
+	**/
+	void stop();
+
+	/**
+	* @return true if counter was measured
+	**/
+	bool valid(Counter counter) const { return mFile[counter] >= 0; }
+
+	/**
+	* @return value of the last measurement, scaled if the kernel had to multiplex the counter
+	**/
+	double value(Counter counter) const { return mValue[counter]; }
+
+	/**
+	* @return short name of counter
+	**/
+	static const char* name(Counter counter);
+
+	/**
+	* @brief writes all valid counters and the instructions per cycle in one line
+	* @return void
+	**/
+	void print(std::ostream& out) const;
+
+private:
+	int mFile[counterCount];	//file descriptors, -1 if unavailable
+	double mValue[counterCount] = {};
+};
@@ -0,0 +1,181 @@
+/**
+* Recorder.cpp
+* @author: Kevin German
+**/
+#include "Recorder.h"
+#include "AlgorithmRegistry.h"
+#include "Benchmark.h"
+#include "Renderer.h"
+#include "RuntimeSettings.h"
+#include "SortControl.h"
+#include <fstream>
+#include <iostream>
+#include <future>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+	/**
+	* @brief YUV4MPEG2 writer (4:4:4, BT.601 limited range). A frame is converted and written asynchronously while the next frame is composed
+	**/
+	class Y4MWriter
+	{
+		std::ofstream mFile;
+		size_t mWidth, mHeight;
+		std::vector<std::uint32_t> mFrame;	//copy of the frame which is encoded
+		std::vector<std::uint8_t> mPlanes;	//Y, U and V plane of the encoded frame
+		std::future<void> mPending;
+
+		void encode()
+		{
+			const auto pixels = mWidth * mHeight;
+			auto* y = mPlanes.data();
+			auto* u = y + pixels;
+			auto* v = u + pixels;
+			for (size_t i = 0; i < pixels; ++i)
+			{
+				const auto r = static_cast<int>((mFrame[i] >> 16) & 0xFF);
+				const auto g = static_cast<int>((mFrame[i] >> 8) & 0xFF);
+				const auto b = static_cast<int>(mFrame[i] & 0xFF);
+				y[i] = static_cast<std::uint8_t>(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+				u[i] = static_cast<std::uint8_t>(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+				v[i] = static_cast<std::uint8_t>(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+			}
+			mFile << "FRAME\n";
+			mFile.write(reinterpret_cast<const char*>(mPlanes.data()), static_cast<std::streamsize>(mPlanes.size()));
+		}
+
+	public:
+		Y4MWriter(const std::string& path, const size_t width, const size_t height, const int fps)
+			: mFile(path, std::ios::binary | std::ios::trunc), mWidth(width), mHeight(height), mFrame(width * height), mPlanes(3 * width * height)
+		{
+			mFile << "YUV4MPEG2 W" << width << " H" << height << " F" << fps << ":1 Ip A1:1 C444\n";
+		}
+
+		~Y4MWriter()
+		{
+			if (mPending.valid())
+				mPending.wait();
+		}
+
+		/**
+		* @return true if the file could be opened and all writes succeeded so far
+		**/
+		bool good() const { return static_cast<bool>(mFile); }
+
+		/**
+		* @brief copies the frame and encodes it asynchronously. waits for the previous frame
+		* @param pixels: ARGB8888 frame of width * height pixels
+		* @return void
+		**/
+		void push(const std::uint32_t* pixels)
+		{
+			if (mPending.valid())
+				mPending.get();
+			std::copy(pixels, pixels + mFrame.size(), mFrame.begin());
+			mPending = std::async(std::launch::async, [this]() { encode(); });
+		}
+
+		/**
+		* @brief waits for the last frame
+		* @return true if all writes succeeded
+		**/
+		bool close()
+		{
+			if (mPending.valid())
+				mPending.get();
+			mFile.close();
+			return !mFile.fail();
+		}
+	};
+}
+
+int record(const RecordSettings& settings, const std::string& outputFile)
+{
+	const auto* algorithm = find_algorithm_by_name(settings.algorithm.c_str());
+	if (algorithm == nullptr)
+	{
+		std::cout << "Error: unknown algorithm \"" << settings.algorithm << "\"\n";
+		return -1;
+	}
+	if (runtime_settings().compareDelay.count() <= 0 && runtime_settings().assignmentDelay.count() <= 0)
+	{
+		std::cout << "Error: the simulated time needs a compare or assignment delay\n";
+		return -1;
+	}
+	if (settings.numberOfElements == 0 || settings.width == 0 || settings.height == 0 || settings.frameStep.count() <= 0 || settings.fps <= 0)
+	{
+		std::cout << "Error: invalid record settings\n";
+		return -1;
+	}
+
+	//input scaled to the height of the video
+	std::vector<int> keys;
+	if (!generate_keys(settings.distribution, settings.numberOfElements, settings.seed, keys))
+	{
+		std::cout << "Error: unknown distribution \"" << settings.distribution << "\"\n";
+		return -1;
+	}
+	const auto maxKey = std::max(1, *std::max_element(keys.begin(), keys.end()));
+	SortingDataArray data(keys.size());
+	for (size_t i = 0; i < keys.size(); ++i)
+		data.setKey(i, static_cast<int>(static_cast<long long>(keys[i]) * settings.height / maxKey));
+	keys = std::vector<int>();
+	data.enableVerification(false);
+
+	Y4MWriter writer(outputFile, settings.width, settings.height, settings.fps);
+	if (!writer.good())
+	{
+		std::cout << "Error: could not create " << outputFile << "\n";
+		return -1;
+	}
+	FrameBuffer frame(settings.width, settings.height, defaultRenderThreads);
+	frame.update(data);
+	writer.push(frame.pixels());
+	size_t frames = 1;
+
+	//the sort blocks at every frame boundary of the simulated time until the frame is composed
+	std::cout << "Recording " << algorithm->name << " (" << settings.numberOfElements << " elements) to " << outputFile << "...\n";
+	const auto start = std::chrono::high_resolution_clock::now();
+	reset_sort_control();
+	set_simulation_clock(settings.frameStep);
+	sort::ScratchArena scratch;
+	if (algorithm->scratch)
+		scratch.reserve(data.size() * sizeof(SortingData));
+	std::thread sorter([algorithm, &data, &settings, &scratch]()
+	{
+		algorithm->sortData(data.begin(), data.end(), { settings.maxThreads, sort_stop_token(), &scratch });
+		end_simulation();
+	});
+	for (; wait_simulation_frame(); ++frames)
+	{
+		frame.update(data);
+		writer.push(frame.pixels());
+		next_simulation_frame();
+	}
+	sorter.join();
+	set_simulation_clock(std::chrono::nanoseconds(0));
+
+	//hold the sorted result for one second
+	for (auto i = 0; i < settings.fps; ++i, ++frames)
+	{
+		frame.update(data);
+		writer.push(frame.pixels());
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+	auto sorted = true;
+	for (size_t i = 1; i < data.size() && sorted; ++i)
+		sorted = data.key(i - 1) <= data.key(i);
+	if (!writer.close())
+	{
+		std::cout << "Error: could not write " << outputFile << "\n";
+		return -1;
+	}
+	std::cout << frames << " frames (" << static_cast<double>(frames) / settings.fps << " s video) recorded in " << elapsed.count() << " s"
+		<< (sorted ? "" : ". Error: data is not sorted") << "\n";
+	return sorted ? 0 : -1;
+}
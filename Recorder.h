@@ -0,0 +1,35 @@
+#pragma once
+/**
+* Recorder.h
+* @author: Kevin German
+**/
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include "settings.h"
+
+/**
+* @brief settings of a headless recording
+**/
+struct RecordSettings
+{
+	std::string algorithm;	//name in the algorithm registry
+	size_t numberOfElements = defaultNumberOfElements;
+	std::string distribution = "uniform";	//see generate_keys
+	unsigned seed = 0;
+	int maxThreads = defaultMaxThreads;
+	unsigned width = defaultScreenWidth;
+	unsigned height = defaultScreenHeight;
+	std::chrono::nanoseconds frameStep{ defaultRecordFrameStep };	//simulated time per frame
+	int fps = defaultRecordFps;
+};
+
+/**
+* @brief sorts with a registered algorithm without window and writes the visualization as raw video (YUV4MPEG2, 4:4:4, e.g. ffmpeg -i sort.y4m sort.mp4).
+* The frames are composed in a CPU framebuffer and taken at a fixed step of the simulated time (the artificial delays of runtime_settings(), see
+* set_simulation_clock), so the video does not depend on the speed of the machine. A writer thread encodes a frame while the next one is composed
+* @param settings: algorithm, input and video settings
+* @param outputFile: path of the video file
+* @return 0 on success, -1 on error
+**/
+int record(const RecordSettings& settings, const std::string& outputFile);
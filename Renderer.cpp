@@ -0,0 +1,277 @@
+/**
+* Renderer.cpp
+* @author: Kevin German
+**/
+#include "Renderer.h"
+#include <algorithm>
+#include <numeric>
+
+void aggregate_columns(SortingDataArray& data, const size_t columns, const size_t firstColumn, const size_t lastColumn, ColumnStats* stats)
+{
+	const auto size = data.size();
+	for (auto x = firstColumn; x < lastColumn; ++x)
+	{
+		const auto first = x * size / columns;
+		const auto last = std::max(first + 1, (x + 1) * size / columns);
+		const auto stride = std::max<size_t>(1, (last - first) / maxSamplesPerColumn);
+
+		ColumnStats column;
+		column.minKey = column.maxKey = data.key(first);
+		column.allCompared = true;
+		long long sum = 0;
+		size_t samples = 0;
+		for (auto i = first, nextSample = first; i < last; ++i)
+		{
+			//keys are sampled, the flags of every element are read so no highlight or unverified element is missed
+			if (i == nextSample)
+			{
+				const auto key = data.key(i);
+				column.minKey = std::min(column.minKey, key);
+				column.maxKey = std::max(column.maxKey, key);
+				sum += key;
+				++samples;
+				nextSample += stride;
+			}
+			//compared() and assigned() reset the flags, so both are always queried
+			const auto compared = data.compared(i);
+			const auto assigned = data.assigned(i);
+			column.compared = column.compared || compared;
+			column.assigned = column.assigned || assigned;
+			column.allCompared = column.allCompared && compared;
+		}
+		column.meanKey = static_cast<int>(sum / static_cast<long long>(samples));
+		stats[x] = column;
+	}
+}
+
+bool SlotTracker::collect(SortingDataArray& data, const size_t slots)
+{
+	if (mStats.size() != slots)
+	{
+		mStats.assign(slots, ColumnStats());
+		mMarked.assign(slots, 0);
+		mSticky.clear();
+		mValid = false;
+	}
+	if (mVerificationEnabled != data.verificationEnabled())
+	{
+		mVerificationEnabled = data.verificationEnabled();
+		mValid = false;
+	}
+
+	mDirty.clear();
+	if (!mValid)
+	{
+		data.takeDirty([](size_t) {});
+		mDirty.resize(slots);
+		std::iota(mDirty.begin(), mDirty.end(), size_t(0));
+		mValid = true;
+		return true;
+	}
+
+	//compared/assigned are reset on read, so slots showing them are aggregated once more. both parts are ascending
+	for (const auto s : mSticky)
+	{
+		mMarked[s] = 1;
+		mDirty.push_back(s);
+	}
+	const auto sticky = mDirty.size();
+	const auto size = data.size();
+	data.takeDirty([this, slots, size](const size_t i)
+	{
+		const auto s = ((i + 1) * slots - 1) / size;	//inverse of the element range of aggregate_columns
+		if (!mMarked[s])
+		{
+			mMarked[s] = 1;
+			mDirty.push_back(s);
+		}
+	});
+	for (const auto s : mDirty)
+		mMarked[s] = 0;
+	std::inplace_merge(mDirty.begin(), mDirty.begin() + static_cast<std::ptrdiff_t>(sticky), mDirty.end());
+	return false;
+}
+
+bool SlotTracker::aggregate(SortingDataArray& data, const size_t slot)
+{
+	const auto drawn = mStats[slot];
+	aggregate_columns(data, mStats.size(), slot, slot + 1, mStats.data());
+	return mStats[slot] != drawn;
+}
+
+void SlotTracker::finish()
+{
+	mSticky.clear();
+	for (const auto s : mDirty)
+		if (mStats[s].assigned || (!mVerificationEnabled && mStats[s].compared))
+			mSticky.push_back(s);
+}
+
+std::uint32_t element_color(const bool compared, const bool assigned, const bool verificationEnabled)
+{
+	if (verificationEnabled)
+		return compared ? verifiedColor : comparedColor;
+	if (compared)
+		return comparedColor;
+	return assigned ? assignedColor : elementColor;
+}
+
+WorkerPool::WorkerPool(const size_t threads)
+{
+	for (size_t i = 0; i + 1 < threads; ++i)
+		mThreads.emplace_back(&WorkerPool::worker, this, i);
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mStart.notify_all();
+	for (auto& thread : mThreads)
+		thread.join();
+}
+
+void WorkerPool::worker(const size_t index)
+{
+	size_t generation = 0;
+	for (;;)
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mStart.wait(lock, [this, generation]() { return mStop || mGeneration != generation; });
+		if (mStop)
+			return;
+		generation = mGeneration;
+		const auto job = mJob;
+		lock.unlock();
+
+		if (job)
+			job(index);
+
+		lock.lock();
+		if (--mPending == 0)
+			mDone.notify_one();
+	}
+}
+
+void WorkerPool::run(const size_t slices, const std::function<void(size_t)>& job)
+{
+	if (slices <= 1 || mThreads.empty())
+	{
+		for (size_t i = 0; i < slices; ++i)
+			job(i);
+		return;
+	}
+	//the last slice runs on the calling thread, workers without a slice get an empty job
+	const auto workers = std::min(slices, size()) - 1;
+	const auto lastSlice = slices - 1;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mJob = [&job, workers](const size_t index)
+		{
+			if (index < workers)
+				job(index);
+		};
+		mPending = mThreads.size();
+		++mGeneration;
+	}
+	mStart.notify_all();
+	for (auto i = workers; i < lastSlice; ++i)
+		job(i);
+	job(lastSlice);
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDone.wait(lock, [this]() { return mPending == 0; });
+	mJob = nullptr;
+}
+
+FrameBuffer::FrameBuffer(const size_t width, const size_t height, const size_t threads)
+	: mWidth(width), mHeight(height), mPixels(width * height, backgroundColor),
+	mRangeTop(width, static_cast<int>(height)), mBarTop(width, static_cast<int>(height)), mColor(width, elementColor), mPool(threads)
+{
+}
+
+std::pair<size_t, size_t> FrameBuffer::update(SortingDataArray& data)
+{
+	const auto slots = std::min(data.size(), mWidth);
+	if (slots == 0)
+		return { 0, 0 };
+	const auto redraw = mSlots.collect(data, slots);
+	if (redraw)
+	{
+		//pixel columns behind the last slot stay empty
+		std::fill(mRangeTop.begin() + static_cast<std::ptrdiff_t>(slots * (mWidth / slots)), mRangeTop.end(), static_cast<int>(mHeight));
+		std::fill(mBarTop.begin() + static_cast<std::ptrdiff_t>(slots * (mWidth / slots)), mBarTop.end(), static_cast<int>(mHeight));
+	}
+
+	//contiguous slices with the same number of dirty slots, small updates are not worth waking the workers
+	const auto count = mSlots.dirty().size();
+	const auto pixels = count * (mWidth / slots) * mHeight;
+	const auto slices = std::max<size_t>(1, std::min(mPool.size(), pixels / minParallelComposePixels));
+	mChanged.assign(slices, { 0, 0 });
+	mPool.run(slices, [this, &data, slices, count, redraw](const size_t slice)
+	{
+		mChanged[slice] = compose(data, slice * count / slices, (slice + 1) * count / slices, redraw);
+	});
+	mSlots.finish();
+
+	auto first = mWidth, last = size_t(0);
+	for (const auto& changed : mChanged)
+	{
+		if (changed.first == changed.second)
+			continue;
+		first = std::min(first, changed.first);
+		last = std::max(last, changed.second);
+	}
+	//behind the last slot
+	if (redraw && mWidth % slots != 0)
+	{
+		rasterize(slots * (mWidth / slots), mWidth);
+		last = mWidth;
+	}
+	return first < last ? std::make_pair(first, last) : std::make_pair(size_t(0), size_t(0));
+}
+
+std::pair<size_t, size_t> FrameBuffer::compose(SortingDataArray& data, const size_t first, const size_t last, const bool redraw)
+{
+	const auto slotWidth = mWidth / mSlots.size();
+	const auto height = static_cast<int>(mHeight);
+	const auto verificationEnabled = mSlots.verificationEnabled();
+	auto firstColumn = mWidth, lastColumn = size_t(0);
+	for (auto i = first; i < last; ++i)
+	{
+		const auto s = mSlots.dirty()[i];
+		if (!mSlots.aggregate(data, s) && !redraw)
+			continue;
+		const auto& stats = mSlots[s];
+		const auto x0 = s * slotWidth;
+		//a single element has no range, aggregated columns show the range up to the max key dimmed
+		const auto color = element_color(verificationEnabled ? stats.allCompared : stats.compared, stats.assigned, verificationEnabled);
+		for (auto x = x0; x < x0 + slotWidth; ++x)
+		{
+			mRangeTop[x] = height - std::min(std::max(stats.maxKey, 0), height);
+			mBarTop[x] = height - std::min(std::max(stats.meanKey, 0), height);
+			mColor[x] = color;
+		}
+		firstColumn = std::min(firstColumn, x0);
+		lastColumn = std::max(lastColumn, x0 + slotWidth);
+	}
+	if (firstColumn >= lastColumn)
+		return { 0, 0 };
+	//unchanged slots between the changed ones are rasterized again with their old state
+	rasterize(firstColumn, lastColumn);
+	return { firstColumn, lastColumn };
+}
+
+void FrameBuffer::rasterize(const size_t first, const size_t last)
+{
+	//row by row, the inner loop is a branch free select which the compiler vectorizes
+	const auto height = static_cast<int>(mHeight);
+	for (auto y = 0; y < height; ++y)
+	{
+		auto* row = &mPixels[static_cast<size_t>(y) * mWidth];
+		for (auto x = first; x < last; ++x)
+			row[x] = y < mRangeTop[x] ? backgroundColor : (y < mBarTop[x] ? rangeColor : mColor[x]);
+	}
+}
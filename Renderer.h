@@ -0,0 +1,209 @@
+#pragma once
+/**
+* Renderer.h
+* @author: Kevin German
+**/
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "SortingDataArray.h"
+
+//colors (ARGB8888)
+static constexpr std::uint32_t backgroundColor = 0xFF000000;
+static constexpr std::uint32_t elementColor = 0xFFFFFFFF;
+static constexpr std::uint32_t comparedColor = 0xFFC21807;
+static constexpr std::uint32_t assignedColor = 0xFF5A1807;
+static constexpr std::uint32_t verifiedColor = 0xFF00A000;
+static constexpr std::uint32_t rangeColor = 0xFF5A5A5A;	//range between mean and max key of aggregated columns
+
+/**
+* @brief aggregated state of all elements which are drawn into one pixel column
+**/
+struct ColumnStats
+{
+	int minKey{ 0 };
+	int maxKey{ 0 };
+	int meanKey{ 0 };
+	bool compared{ false };	//any element was compared
+	bool assigned{ false };	//any element was assigned
+	bool allCompared{ false };	//all elements were compared (verification mode: all in correct order)
+
+	bool operator==(const ColumnStats& other) const
+	{
+		return minKey == other.minKey && maxKey == other.maxKey && meanKey == other.meanKey
+			&& compared == other.compared && assigned == other.assigned && allCompared == other.allCompared;
+	}
+	bool operator!=(const ColumnStats& other) const { return !(*this == other); }
+};
+
+/**
+* @brief color of an element or column
+* @param compared: element was compared (verification mode: is in correct order)
+* @param assigned: element was assigned
+* @param verificationEnabled: verification mode
+* @return ARGB8888 color
+**/
+std::uint32_t element_color(bool compared, bool assigned, bool verificationEnabled);
+
+/**
+* @brief level of detail aggregation for more elements than pixel columns. Column x covers the elements [x * size / columns, (x + 1) * size / columns).
+* The keys of columns with more than maxSamplesPerColumn elements are sampled with a fixed stride. The compared/assigned flags are combined over
+* all elements of a column, only the columns with dirty elements are aggregated per frame (SlotTracker)
+* @param data: visualized elements
+* @param columns: total number of pixel columns
+* @param firstColumn: first column to aggregate
+* @param lastColumn: column behind the last column to aggregate
+* @param stats: output, stats[x] for x in [firstColumn, lastColumn)
+* @return void
+**/
+void aggregate_columns(SortingDataArray& data, size_t columns, size_t firstColumn, size_t lastColumn, ColumnStats* stats);
+
+/**
+* @brief state of the drawn slots: one slot per element, or one slot per pixel column if there are more elements than columns (aggregated).
+* Only the slots with dirty elements (SortingDataArray::takeDirty) and the slots which show a state that is reset on read (assigned, compared)
+* are aggregated again, so a frame costs time for the changes instead of for all elements
+**/
+class SlotTracker
+{
+	std::vector<ColumnStats> mStats;	//state per slot
+	std::vector<char> mMarked;	//slot is in mDirty
+	std::vector<size_t> mDirty;	//slots to aggregate in ascending order
+	std::vector<size_t> mSticky;	//slots which show assigned or compared, in ascending order
+	bool mValid{ false };	//false: all slots are dirty
+	bool mVerificationEnabled{ false };
+
+public:
+	/**
+	* @brief collects the dirty slots of this frame into dirty()
+	* @param data: visualized elements
+	* @param slots: number of slots, at most data.size()
+	* @return true if all slots are dirty (first frame, slot count or verification mode changed, invalidate())
+	**/
+	bool collect(SortingDataArray& data, size_t slots);
+
+	/**
+	* @brief aggregates one slot again. Different slots may be aggregated concurrently
+	* @return true if the state of the slot changed
+	**/
+	bool aggregate(SortingDataArray& data, size_t slot);
+
+	/**
+	* @brief ends the frame after all dirty slots were aggregated
+	* @return void
+	**/
+	void finish();
+
+	/**
+	* @brief all slots are dirty with the next collect
+	* @return void
+	**/
+	void invalidate() { mValid = false; }
+
+	const std::vector<size_t>& dirty() const { return mDirty; }
+	const ColumnStats& operator[](const size_t slot) const { return mStats[slot]; }
+	size_t size() const { return mStats.size(); }
+	bool verificationEnabled() const { return mVerificationEnabled; }
+};
+
+/**
+* @brief fixed set of worker threads which run one job per frame. The calling thread works on the last slice
+**/
+class WorkerPool
+{
+	std::vector<std::thread> mThreads;
+	std::mutex mMutex;
+	std::condition_variable mStart;	//new job or stop
+	std::condition_variable mDone;	//all workers finished the job
+	std::function<void(size_t)> mJob;
+	size_t mGeneration{ 0 };	//number of started jobs
+	size_t mPending{ 0 };	//workers which have not finished the current job
+	bool mStop{ false };
+
+	void worker(size_t index);
+
+public:
+	/**
+	* @brief starts the worker threads
+	* @param threads: number of slices including the calling thread (1: no worker threads)
+	**/
+	explicit WorkerPool(size_t threads);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	/**
+	* @return number of slices (worker threads + calling thread)
+	**/
+	size_t size() const { return mThreads.size() + 1; }
+
+	/**
+	* @brief runs job(i) for every slice i < slices on the workers and the calling thread and returns after all slices finished (barrier)
+	* @param slices: number of slices, at most size()
+	* @param job: called with the slice index
+	* @return void
+	**/
+	void run(size_t slices, const std::function<void(size_t)>& job);
+};
+
+/**
+* @brief CPU framebuffer (ARGB8888, row major) of the visualization. update() aggregates only the dirty slots (SlotTracker) and rasterizes only
+* the slots whose state changed, the pixels stay valid between frames so only the changed span has to be uploaded to the screen.
+* The dirty slots are split into slices with the same number of slots, each slice is aggregated and rasterized by one thread of the pool
+**/
+class FrameBuffer
+{
+	size_t mWidth;
+	size_t mHeight;
+	std::vector<std::uint32_t> mPixels;
+	SlotTracker mSlots;	//state per slot, equal to mPixels after update()
+	std::vector<std::pair<size_t, size_t>> mChanged;	//changed pixel columns per slice
+	std::vector<int> mRangeTop, mBarTop;	//first row of the range and of the bar per pixel column
+	std::vector<std::uint32_t> mColor;	//bar color per pixel column
+	WorkerPool mPool;
+
+	/**
+	* @brief aggregates the dirty slots mSlots.dirty()[first, last) and rasterizes the pixel columns of the changed ones
+	* @param redraw: rasterize all of them, even if their state did not change
+	* @return changed pixel columns [first, last), first == last if nothing changed
+	**/
+	std::pair<size_t, size_t> compose(SortingDataArray& data, size_t first, size_t last, bool redraw);
+
+	/**
+	* @brief draws the pixel columns [first, last) from mRangeTop, mBarTop and mColor
+	* @return void
+	**/
+	void rasterize(size_t first, size_t last);
+
+public:
+	/**
+	* @brief constructor. all pixels are background
+	* @param width: width in pixels
+	* @param height: height in pixels
+	* @param threads: threads which compose a frame (including the calling thread)
+	**/
+	FrameBuffer(size_t width, size_t height, size_t threads = 1);
+
+	/**
+	* @brief draws the current state of data into the framebuffer
+	* @param data: visualized elements
+	* @return changed pixel columns [first, last). first == last if nothing changed
+	**/
+	std::pair<size_t, size_t> update(SortingDataArray& data);
+
+	/**
+	* @brief redraw everything with the next update (e.g. after the screen was drawn by another renderer)
+	* @return void
+	**/
+	void invalidate() { mSlots.invalidate(); }
+
+	const std::uint32_t* pixels() const { return mPixels.data(); }
+	size_t width() const { return mWidth; }
+	size_t height() const { return mHeight; }
+	size_t pitch() const { return mWidth * sizeof(std::uint32_t); }	//bytes per row
+};
@@ -0,0 +1,29 @@
+/**
+* RuntimeSettings.cpp
+* @author: Kevin German
+**/
+#include "RuntimeSettings.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	const RuntimeSettings defaultSettings{};
+	std::atomic<const RuntimeSettings*> currentSettings{ &defaultSettings };
+	std::mutex publishMutex;	//protects publishedSettings
+	std::vector<std::unique_ptr<const RuntimeSettings>> publishedSettings;	//old blocks are kept, readers may still use them
+}
+
+const RuntimeSettings& runtime_settings()
+{
+	return *currentSettings.load(std::memory_order_acquire);
+}
+
+void set_runtime_settings(const RuntimeSettings& settings)
+{
+	std::lock_guard<std::mutex> lock(publishMutex);
+	publishedSettings.push_back(std::make_unique<const RuntimeSettings>(settings));
+	currentSettings.store(publishedSettings.back().get(), std::memory_order_release);
+}
@@ -0,0 +1,30 @@
+#pragma once
+/**
+* RuntimeSettings.h
+* @author: Kevin German
+**/
+#include <chrono>
+#include "settings.h"
+
+/**
+* @brief settings which are shared by all elements and can change while a sort is running.
+* A block is never modified after it was published, changes publish a new block (atomic pointer swap)
+**/
+struct RuntimeSettings
+{
+	std::chrono::nanoseconds compareDelay{ defaultCompareDelay };	//artificial delay for comparisons
+	std::chrono::nanoseconds assignmentDelay{ defaultAssignmentDelay };	//artificial delay for assignments
+};
+
+/**
+* @brief current runtime settings (lock free)
+* @return reference to the current settings block. blocks stay valid for the lifetime of the program
+**/
+const RuntimeSettings& runtime_settings();
+
+/**
+* @brief publishes new runtime settings. running sorts use them from their next comparison/assignment on
+* @param settings: new settings
+* @return void
+**/
+void set_runtime_settings(const RuntimeSettings& settings);
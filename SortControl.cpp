@@ -0,0 +1,158 @@
+/**
+* SortControl.cpp
+* @author: Kevin German
+**/
+#include "SortControl.h"
+#include "settings.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace
+{
+	std::atomic<bool> paused{ false };
+	sort::StopSource cancelled;
+	std::mutex pauseMutex;
+	std::condition_variable pauseCondition;	//notified on resume and cancel
+
+	//simulation clock
+	std::atomic<long long> simulationStep{ 0 };	//ns, 0: disabled
+	std::atomic<long long> simulatedTime{ 0 };	//ns
+	long long frameTime = 0;	//next frame boundary (ns). guarded by frameMutex
+	bool simulationEnded = false;	//guarded by frameMutex
+	std::mutex frameMutex;
+	std::condition_variable frameReached;	//sort thread -> recorder
+	std::condition_variable frameTaken;	//recorder -> sort threads
+
+	/**
+	* @brief simulation clock part of sort_checkpoint
+	* @return false if cancelled while waiting for the frame
+	**/
+	bool advance_simulation(const std::chrono::nanoseconds delay)
+	{
+		const auto time = simulatedTime.fetch_add(delay.count(), std::memory_order_relaxed) + delay.count();
+		std::unique_lock<std::mutex> lock(frameMutex);
+		if (time < frameTime)
+			return true;
+		frameReached.notify_one();
+		frameTaken.wait(lock, [time]() { return time < frameTime || simulationEnded || cancelled.stop_requested(); });
+		return !cancelled.stop_requested();
+	}
+
+	/**
+	* @brief pause part of the checkpoints
+	* @return false if the sort was cancelled
+	**/
+	bool wait_while_paused()
+	{
+		if (paused.load(std::memory_order_relaxed))
+		{
+			std::unique_lock<std::mutex> lock(pauseMutex);
+			pauseCondition.wait(lock, []() { return !paused || cancelled.stop_requested(); });
+		}
+		return !cancelled.stop_requested();
+	}
+}
+
+void pause_sort(const bool pause)
+{
+	{
+		std::lock_guard<std::mutex> lock(pauseMutex);
+		paused = pause;
+	}
+	pauseCondition.notify_all();
+}
+
+bool sort_paused()
+{
+	return paused;
+}
+
+void cancel_sort()
+{
+	{
+		std::lock_guard<std::mutex> lock(pauseMutex);
+		cancelled.request_stop();
+		paused = false;
+	}
+	pauseCondition.notify_all();
+	{
+		std::lock_guard<std::mutex> lock(frameMutex);	//threads waiting for a frame check the cancel state under this mutex
+	}
+	frameTaken.notify_all();
+}
+
+bool sort_cancelled()
+{
+	return cancelled.stop_requested();
+}
+
+void reset_sort_control()
+{
+	std::lock_guard<std::mutex> lock(pauseMutex);
+	cancelled.reset();
+	paused = false;
+}
+
+sort::StopToken sort_stop_token()
+{
+	return cancelled.token();
+}
+
+bool sort_checkpoint(const std::chrono::nanoseconds delay)
+{
+	if (!wait_while_paused())
+		return false;
+	if (delay.count() > 0)
+	{
+		if (simulationStep.load(std::memory_order_relaxed) != 0)
+			return advance_simulation(delay);
+		std::this_thread::sleep_for(delay);
+	}
+	return true;
+}
+
+bool move_checkpoint()
+{
+	if (!wait_while_paused())
+		return false;
+	if (simulationStep.load(std::memory_order_relaxed) != 0)
+		return advance_simulation(simulatedMoveTime);
+	return true;
+}
+
+void set_simulation_clock(const std::chrono::nanoseconds step)
+{
+	std::lock_guard<std::mutex> lock(frameMutex);
+	simulationStep = step.count();
+	simulatedTime = 0;
+	frameTime = step.count();
+	simulationEnded = false;
+}
+
+bool wait_simulation_frame()
+{
+	std::unique_lock<std::mutex> lock(frameMutex);
+	frameReached.wait(lock, []() { return simulatedTime >= frameTime || simulationEnded; });
+	return !simulationEnded;
+}
+
+void next_simulation_frame()
+{
+	{
+		std::lock_guard<std::mutex> lock(frameMutex);
+		frameTime += simulationStep;
+	}
+	frameTaken.notify_all();
+}
+
+void end_simulation()
+{
+	{
+		std::lock_guard<std::mutex> lock(frameMutex);
+		simulationEnded = true;
+	}
+	frameReached.notify_all();
+	frameTaken.notify_all();
+}
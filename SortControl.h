@@ -0,0 +1,87 @@
+#pragma once
+/**
+* SortControl.h
+* @author: Kevin German
+**/
+#include "sort.h"
+#include <chrono>
+
+/**
+* @brief pause or resume the running sort. A paused sort blocks in its next comparison/assignment
+* @param pause: true for pause, false for resume
+* @return void
+**/
+void pause_sort(bool pause);
+
+/**
+* @brief check if the sort is paused
+* @return true if paused
+**/
+bool sort_paused();
+
+/**
+* @brief cancel the running sort (resumes it if paused). Comparisons and assignments skip their delays and all elements compare as equal,
+* so every algorithm finishes immediately and the data stays a valid permutation
+* @return void
+**/
+void cancel_sort();
+
+/**
+* @brief check if the running sort was cancelled
+* @return true if cancelled
+**/
+bool sort_cancelled();
+
+/**
+* @brief token of the cancel request for the parallel sort templates, which stop splitting work and let their worker tasks return
+* @return token which stays valid for the lifetime of the program
+**/
+sort::StopToken sort_stop_token();
+
+/**
+* @brief reset pause and cancel state before the next sort starts
+* @return void
+**/
+void reset_sort_control();
+
+/**
+* @brief cooperative checkpoint of the element hooks (SortingData, SortingDataArray). Blocks while the sort is paused and waits for delay afterwards.
+* With the simulation clock the delay advances the simulated time instead, and the thread blocks at every frame boundary until the frame was taken
+* @param delay: artificial delay of the operation
+* @return false if the sort was cancelled (delay was skipped)
+**/
+bool sort_checkpoint(std::chrono::nanoseconds delay);
+
+/**
+* @brief checkpoint of a move (sort_checkpoint without delay). With the simulation clock a move advances the simulated time by simulatedMoveTime,
+* so algorithms which only move elements (radixsort, countingsort) progress in the recording as well
+* @return false if the sort was cancelled
+**/
+bool move_checkpoint();
+
+/**
+* @brief enables the simulation clock (headless recording): sort_checkpoint does not sleep but adds its delay to a simulated time, which is the
+* total work of all sort threads. A thread which reaches the next frame boundary blocks until the frame was taken, so frames are taken at a fixed
+* simulated time step independent of the wall clock speed. Resets the simulated time, must not be called while a sort is running
+* @param step: simulated time per frame. 0 disables the simulation clock
+* @return void
+**/
+void set_simulation_clock(std::chrono::nanoseconds step);
+
+/**
+* @brief blocks until the simulated time reached the next frame boundary or the simulation was ended
+* @return true if a frame has to be taken (call next_simulation_frame afterwards), false if the simulation was ended
+**/
+bool wait_simulation_frame();
+
+/**
+* @brief moves the frame boundary one step further and resumes the threads which waited for the taken frame
+* @return void
+**/
+void next_simulation_frame();
+
+/**
+* @brief ends the simulation after the sort finished (wait_simulation_frame returns false)
+* @return void
+**/
+void end_simulation();
@@ -3,22 +3,15 @@
 * @author: Kevin German
 **/
 #include "SortingData.h"
+#include "RuntimeSettings.h"
+#include "SortControl.h"
 #include "sort.h"
 #include <chrono>
 #include <thread>
 #include <mutex>
-#include <exception>
-
-extern bool sortingDisabled;	//used for stopping sorting algorithms immediately (in case of a user event)
-
-void SortingData::setDelay(const std::chrono::nanoseconds compareDelay,const std::chrono::nanoseconds assignmentDelay)
-{
-	mCompareDelay = compareDelay;
-	mAssignmentDelay = assignmentDelay;
-}
 
 SortingData::SortingData(SortingData&& other) noexcept
-	: mAssignmentDelay(other.mAssignmentDelay),mCompareDelay(other.mCompareDelay), mRecentlyAssigned(true), mKey(other.mKey)
+	: mRecentlyAssigned(true), mKey(other.mKey)
 {
 	other.mRecentlyAssigned = false;
 	other.mKey = 0;
@@ -26,12 +19,12 @@ SortingData::SortingData(SortingData&& other) noexcept
 }
 
 SortingData::SortingData(const SortingData& other)
-	: mAssignmentDelay(other.mAssignmentDelay), mCompareDelay(other.mCompareDelay), mRecentlyAssigned(true), mKey(other.mKey)
+	: mRecentlyAssigned(true)
 {
-	std::lock(mMutex, other.mMutex);
-	std::lock_guard<std::mutex> lock(mMutex,std::adopt_lock);
-	std::lock_guard<std::mutex> lockOther(other.mMutex,std::adopt_lock);	
-	std::this_thread::sleep_for(mAssignmentDelay); //delay to simulate heavy copy work
+	//delay to simulate heavy copy work. the checkpoint may block for a frame, so no mutex is held while waiting
+	sort_checkpoint(runtime_settings().assignmentDelay);
+	std::lock_guard<std::mutex> lockOther(other.mMutex);
+	mKey = other.mKey;
 }
 
 
@@ -60,7 +53,9 @@ bool SortingData::operator<(const SortingData& other) const
 			other.mRecentlyCompared = true;
 		}
 	}
-	std::this_thread::sleep_for(mCompareDelay);//delay to simulate heavy comparison work
+	//delay to simulate heavy comparison work. a cancelled sort sees only equal elements and finishes immediately
+	if (!sort_checkpoint(runtime_settings().compareDelay * (mVerificationEnabled ? timeForVerification : 1)))
+		return false;
 	return mKey < other.mKey;
 }
 
@@ -74,9 +69,6 @@ int SortingData::operator&(const int other) const
 
 SortingData& SortingData::operator=(const SortingData &other)
 {
-	if (sortingDisabled)
-		throw std::exception("Sort interrupted by user input. ");
-
 	if (this != &other)
 	{
 		{
@@ -86,16 +78,14 @@ SortingData& SortingData::operator=(const SortingData &other)
 			mRecentlyAssigned = true;
 			mKey = other.mKey;
 		}
-		std::this_thread::sleep_for(mAssignmentDelay);	//delay to simulate heavy copy work
+		sort_checkpoint(runtime_settings().assignmentDelay);	//delay to simulate heavy copy work
 	}
 	return *this;
 }
 
 SortingData& SortingData::operator=(SortingData&& other)
 {
-	if (sortingDisabled)
-		throw std::exception("Sort interrupted by user input. ");
-
+	move_checkpoint();
 	{	
 		std::lock_guard<std::mutex> lockThis(mMutex);
 		mKey = other.mKey;
@@ -137,10 +127,6 @@ void SortingData::enableVerification(const bool enable)
 	std::lock_guard<std::mutex> lock(mMutex);
 	mRecentlyAssigned = false;
 	mRecentlyCompared = false;
-	if (enable)
-	{
-		mCompareDelay = mCompareDelay*timeForVerification;
-	}
 	mVerificationEnabled = enable;
 }
 
@@ -10,8 +10,6 @@
 class SortingData
 {
 	mutable std::mutex mMutex;	//mutex for protecting the internal data from race conditions
-	std::chrono::nanoseconds mAssignmentDelay{ defaultAssignmentDelay }; //artificial delay for assignments
-	std::chrono::nanoseconds mCompareDelay{ defaultCompareDelay };	//artificial delay for comparisons
 	bool mRecentlyAssigned{ false }; //true if recently assigned
 	mutable bool mRecentlyCompared{false};	//true if recently compared
 	bool mVerificationEnabled{ false }; //used for visualizing the verification process
@@ -48,7 +46,7 @@ public:
 	~SortingData() = default;
 
 	/**
-	* @brief classic comparison operator '<'. modifies internal state of booth object (despite constness) and has a artificial delay build in (mCompareDelay)
+	* @brief classic comparison operator '<'. modifies internal state of booth object (despite constness) and has a artificial delay build in (runtime_settings().compareDelay)
 	* @param other: reference to the object on the right side of '<'
 	* @return true if this->mKey < other.mKey
 	* @note modifies internal state of both objects. The fake constness is necessary for some algorithms in the stl (like std::inplace_merge)
@@ -63,14 +61,14 @@ public:
 	int operator&(int other) const;
 
 	/**
-	* @brief assignment operator '=' with artificial delay(mAssignmentDelay)
+	* @brief assignment operator '=' with artificial delay(runtime_settings().assignmentDelay)
 	* @param other: SortingData
 	* @return reference to this object
 	**/
 	SortingData& operator=(const SortingData & other);
 
 	/**
-	* @brief move assignment operator '=' without artificial delay(mAssignmentDelay)
+	* @brief move assignment operator '=' without artificial delay(runtime_settings().assignmentDelay)
 	* @param other SortingData rvalue
 	* @return reference to this object
 	**/
@@ -96,7 +94,7 @@ public:
 
 	/**
 	* @brief enable verification mode. if enabled all calls to compared() and assigned() will not modify the state back to not compared.
-	* Resets assigned and compare flag as well and increases the time needed for comparisons (looks better in visualization process)
+	* Resets assigned and compare flag as well. Comparisons take timeForVerification times longer in verification mode (looks better in visualization process)
 	* @return void
 	**/
 	void enableVerification(bool enable);
@@ -106,11 +104,4 @@ public:
 	* @return true if verification mode is enabled
 	**/
 	bool verificationEnabled() const;
-
-	/**
-	* @brief classic comparison operator '<'. modifies internal state of booth object (despite constness) and has a artificial delay build in (mCompareDelay)
-	* @param compareDelay: std::chrono::nanoseconds. Sets minimum time needed for comparisions to this value
-	* @param assignmentDelay: std::chrono::nanoseconds. Sets minimum time needed for assignments to this value
-	**/
-	void setDelay(std::chrono::nanoseconds compareDelay, std::chrono::nanoseconds assignmentDelay);
 };
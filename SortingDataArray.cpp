@@ -0,0 +1,149 @@
+/**
+* SortingDataArray.cpp
+* @author: Kevin German
+**/
+#include "SortingDataArray.h"
+#include "RuntimeSettings.h"
+#include "SortControl.h"
+
+SortingDataArray::SortingDataArray(const size_t size)
+	: mSize(size), mKeys(new std::atomic<int>[size]()), mFlags(new std::atomic<std::uint8_t>[size]()), mDirty(new std::atomic<std::uint64_t>[dirtyWords()]()),
+	mDirtySummary(new std::atomic<std::uint64_t>[summaryWords()]())
+{
+}
+
+void SortingDataArray::setKey(const size_t index, const int key)
+{
+	mKeys[index].store(key, std::memory_order_relaxed);
+	markDirty(index);
+}
+
+bool SortingDataArray::compared(const size_t index)
+{
+	if (mVerificationEnabled)
+		return (mFlags[index].load(std::memory_order_relaxed) & flagCompared) != 0;
+	return (mFlags[index].fetch_and(static_cast<std::uint8_t>(~flagCompared), std::memory_order_relaxed) & flagCompared) != 0;
+}
+
+bool SortingDataArray::assigned(const size_t index)
+{
+	return (mFlags[index].fetch_and(static_cast<std::uint8_t>(~flagAssigned), std::memory_order_relaxed) & flagAssigned) != 0;
+}
+
+void SortingDataArray::enableVerification(const bool enable)
+{
+	for (size_t i = 0; i < mSize; ++i)
+		mFlags[i].store(0, std::memory_order_relaxed);
+	mVerificationEnabled = enable;
+	for (size_t i = 0; i < dirtyWords(); ++i)
+		mDirty[i].store(~std::uint64_t(0), std::memory_order_release);
+	for (size_t i = 0; i < summaryWords(); ++i)
+		mDirtySummary[i].store(~std::uint64_t(0), std::memory_order_release);
+}
+
+void SortingDataArray::assign(const size_t index, const int key, const bool copy)
+{
+	mKeys[index].store(key, std::memory_order_relaxed);
+	mFlags[index].fetch_or(flagAssigned, std::memory_order_relaxed);
+	markDirty(index);
+	//delay to simulate heavy copy work, moves only advance the simulation clock
+	if (copy)
+		sort_checkpoint(runtime_settings().assignmentDelay);
+	else
+		move_checkpoint();
+}
+
+void SortingDataArray::markCompared(const size_t index, const bool inOrder)
+{
+	//in verification mode only elements in correct order are marked
+	if (mVerificationEnabled && inOrder)
+		mFlags[index].fetch_and(static_cast<std::uint8_t>(~flagCompared), std::memory_order_relaxed);
+	else
+		mFlags[index].fetch_or(flagCompared, std::memory_order_relaxed);
+	markDirty(index);
+}
+
+bool SortingDataArray::compareDelay() const
+{
+	//delay to simulate heavy comparison work. a cancelled sort sees only equal elements and finishes immediately
+	return sort_checkpoint(runtime_settings().compareDelay * (mVerificationEnabled ? timeForVerification : 1));
+}
+
+
+bool SortingDataArray::reference::compare(const int key, const bool keyIsLeft) const
+{
+	const auto less = keyIsLeft ? key < this->key() : this->key() < key;
+	mArray->markCompared(mIndex, less);
+	return mArray->compareDelay() && less;
+}
+
+SortingDataArray::reference& SortingDataArray::reference::operator=(const reference& other)
+{
+	assign(other.key(), false);
+	return *this;
+}
+
+SortingDataArray::reference& SortingDataArray::reference::operator=(const SortingData& other)
+{
+	assign(other.mKey, true);
+	return *this;
+}
+
+SortingDataArray::reference& SortingDataArray::reference::operator=(SortingData&& other)
+{
+	assign(other.mKey, false);
+	return *this;
+}
+
+SortingDataArray::reference::operator SortingData() const
+{
+	return SortingData(key());
+}
+
+bool SortingDataArray::reference::operator<(const reference& other) const
+{
+	const auto less = key() < other.key();
+	mArray->markCompared(mIndex, less);
+	other.mArray->markCompared(other.mIndex, less);
+	return mArray->compareDelay() && less;
+}
+
+bool SortingDataArray::reference::operator<(const SortingData& other) const
+{
+	return compare(other.mKey, false);
+}
+
+bool operator<(const SortingData& lhs, const SortingDataArray::reference& rhs)
+{
+	return rhs.compare(lhs.mKey, true);
+}
+
+int SortingDataArray::reference::operator&(const int other) const
+{
+	return key() & other;
+}
+
+SortingDataArray::reference& SortingDataArray::reference::operator++()
+{
+	assign(key() + 1, false);
+	return *this;
+}
+
+void swap(const SortingDataArray::reference lhs, const SortingDataArray::reference rhs)
+{
+	const auto key = lhs.key();
+	lhs.assign(rhs.key(), false);
+	rhs.assign(key, false);
+}
+
+void swap(const SortingDataArray::reference lhs, SortingData& rhs)
+{
+	const auto key = lhs.key();
+	lhs.assign(rhs.mKey, false);
+	rhs.mKey = key;
+}
+
+void swap(SortingData& lhs, const SortingDataArray::reference rhs)
+{
+	swap(rhs, lhs);
+}
@@ -0,0 +1,310 @@
+#pragma once
+/**
+* SortingDataArray.h
+* @author: Kevin German
+**/
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "settings.h"
+#include "SortingData.h"
+
+/**
+* @brief structure of arrays storage for the visualized elements. The keys are stored in one contiguous array, the compare/assign state
+* in a separate byte array. The delays are shared by all elements (runtime_settings()). Elements are accessed through proxy references which add the same
+* artificial delays and state changes as SortingData, so all templates in sort.h (and the stl algorithms) work on SortingDataArray::iterator.
+* Temporary elements of the algorithms (pivots, buffers) are SortingData objects.
+* Every change of a key or state also sets the element's bit in a dirty bitmap, so the renderer only has to look at changed elements.
+* A summary bitmap marks the non-zero words of the dirty bitmap, so unchanged parts of the array are skipped 4096 elements at a time.
+**/
+class SortingDataArray
+{
+public:
+	class reference;
+	class iterator;
+	using value_type = SortingData;
+
+	/**
+	* @brief constructor. all keys are 0
+	* @param size: number of elements
+	**/
+	explicit SortingDataArray(size_t size);
+
+	SortingDataArray(const SortingDataArray&) = delete;
+	SortingDataArray& operator=(const SortingDataArray&) = delete;
+
+	/**
+	* @return number of elements
+	**/
+	size_t size() const { return mSize; }
+
+	/**
+	* @return iterator to the first element
+	**/
+	iterator begin();
+
+	/**
+	* @return iterator behind the last element
+	**/
+	iterator end();
+
+	/**
+	* @param index: index of the element
+	* @return proxy reference to the element
+	**/
+	reference operator[](size_t index);
+
+	/**
+	* @brief read key without delay and without modifying the state (used for drawing)
+	* @param index: index of the element
+	* @return key of the element
+	**/
+	int key(const size_t index) const { return mKeys[index].load(std::memory_order_relaxed); }
+
+	/**
+	* @brief write key without delay and without modifying the state (used for initialisation)
+	* @param index: index of the element
+	* @param key: new key
+	* @return void
+	**/
+	void setKey(size_t index, int key);
+
+	/**
+	* @brief check if element was recently compared (used for visualizing comparison operations)
+	* @param index: index of the element
+	* @return true if element was compared and modify state back to not compared (unless verification mode is enabled)
+	**/
+	bool compared(size_t index);
+
+	/**
+	* @brief check if element was recently assigned (used for visualizing assignment operations)
+	* @param index: index of the element
+	* @return true if element was assigned recently and modify state back to not assigned
+	**/
+	bool assigned(size_t index);
+
+	/**
+	* @brief enable verification mode for all elements. see SortingData::enableVerification
+	* @return void
+	**/
+	void enableVerification(bool enable);
+
+	/**
+	* @brief check if verification mode is enabled
+	* @return true if verification mode is enabled
+	**/
+	bool verificationEnabled() const { return mVerificationEnabled; }
+
+	/**
+	* @return number of words of the dirty bitmap (64 elements per word)
+	**/
+	size_t dirtyWords() const { return (mSize + 63) / 64; }
+
+	/**
+	* @brief takes and resets all dirty bits. Only the bitmap words marked in the summary are read
+	* @param onDirty: called with the index of every element whose key or state changed since the last call, in ascending order
+	* @return void
+	**/
+	template <typename F>
+	void takeDirty(F onDirty)
+	{
+		const auto words = dirtyWords();
+		for (size_t group = 0; group < summaryWords(); ++group)
+		{
+			//summary before words: a word which is set after its summary bit was taken marks the summary again
+			for (auto marked = mDirtySummary[group].exchange(0, std::memory_order_acquire); marked != 0; marked &= marked - 1)
+			{
+				const auto word = group * 64 + lowestBit(marked);
+				if (word >= words)
+					break;
+				for (auto bits = mDirty[word].exchange(0, std::memory_order_acquire); bits != 0; bits &= bits - 1)
+				{
+					const auto index = word * 64 + lowestBit(bits);
+					if (index < mSize)
+						onDirty(index);
+				}
+			}
+		}
+	}
+
+	/**
+	* @brief sets the dirty bit of an element (e.g. the renderer shows a state which is reset on read and has to be redrawn)
+	* @param index: index of the element
+	* @return void
+	**/
+	void markDirty(const size_t index)
+	{
+		const auto word = index / 64;
+		//the first bit of a word marks the word in the summary
+		if (mDirty[word].fetch_or(std::uint64_t(1) << (index % 64), std::memory_order_release) == 0)
+			mDirtySummary[word / 64].fetch_or(std::uint64_t(1) << (word % 64), std::memory_order_release);
+	}
+
+private:
+	enum : std::uint8_t
+	{
+		flagCompared = 1,
+		flagAssigned = 2
+	};
+
+	size_t mSize;
+	std::unique_ptr<std::atomic<int>[]> mKeys;	//keys used for comparisons
+	std::unique_ptr<std::atomic<std::uint8_t>[]> mFlags;	//recently compared/assigned state of each element
+	std::unique_ptr<std::atomic<std::uint64_t>[]> mDirty;	//one bit per element, set on every change. release/acquire: a taken bit shows the new key
+	std::unique_ptr<std::atomic<std::uint64_t>[]> mDirtySummary;	//one bit per word of mDirty, set if the word may be non-zero
+	std::atomic<bool> mVerificationEnabled{ false }; //used for visualizing the verification process
+
+	size_t summaryWords() const { return (dirtyWords() + 63) / 64; }
+
+	/**
+	* @param bits: must not be 0
+	* @return index of the lowest set bit
+	**/
+	static size_t lowestBit(const std::uint64_t bits)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return index;
+#else
+		return static_cast<size_t>(__builtin_ctzll(bits));
+#endif
+	}
+
+	void assign(size_t index, int key, bool copy);
+	void markCompared(size_t index, bool inOrder);
+	bool compareDelay() const;
+
+	friend class reference;
+};
+
+
+/**
+* @brief proxy reference to one element of a SortingDataArray. behaves like SortingData&
+**/
+class SortingDataArray::reference
+{
+	SortingDataArray* mArray;
+	size_t mIndex;
+
+	friend class SortingDataArray;
+	friend class iterator;
+	reference(SortingDataArray* array, const size_t index) : mArray(array), mIndex(index) {}
+
+	int key() const { return mArray->key(mIndex); }
+	void assign(const int key, const bool copy) const { mArray->assign(mIndex, key, copy); }
+	bool compare(int key, bool keyIsLeft) const;
+
+public:
+	reference(const reference&) = default;
+
+	/**
+	* @brief assignment between two elements of the array. treated as move (no artificial delay)
+	**/
+	reference& operator=(const reference& other);
+
+	/**
+	* @brief assignment operator '=' with artificial delay
+	**/
+	reference& operator=(const SortingData& other);
+
+	/**
+	* @brief move assignment operator '=' without artificial delay
+	**/
+	reference& operator=(SortingData&& other);
+
+	/**
+	* @brief read the element into a temporary SortingData. treated as move (no artificial delay)
+	**/
+	operator SortingData() const;
+
+	/**
+	* @brief comparison operator '<' with artificial delay. marks both elements as compared
+	**/
+	bool operator<(const reference& other) const;
+
+	/**
+	* @brief comparison operator '<' with a temporary element with artificial delay. marks this element as compared
+	**/
+	bool operator<(const SortingData& other) const;
+	friend bool operator<(const SortingData& lhs, const reference& rhs);
+
+	/**
+	* @brief classic bitwise operator
+	**/
+	int operator&(int other) const;
+
+	/**
+	* @brief increment operator (prefix). neded for std::iota
+	**/
+	reference& operator++();
+
+	/**
+	* @brief swaps the keys of two elements without artificial delay (like std::swap with move operations)
+	**/
+	friend void swap(reference lhs, reference rhs);
+	friend void swap(reference lhs, SortingData& rhs);
+	friend void swap(SortingData& lhs, reference rhs);
+};
+
+
+/**
+* @brief random access iterator of SortingDataArray
+**/
+class SortingDataArray::iterator
+{
+	SortingDataArray* mArray{ nullptr };
+	std::ptrdiff_t mIndex{ 0 };
+
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = SortingData;
+	using difference_type = std::ptrdiff_t;
+	using pointer = void;
+	using reference = SortingDataArray::reference;
+
+	iterator() = default;
+	iterator(SortingDataArray* array, const std::ptrdiff_t index) : mArray(array), mIndex(index) {}
+
+	reference operator*() const { return reference(mArray, static_cast<size_t>(mIndex)); }
+	reference operator[](const difference_type n) const { return reference(mArray, static_cast<size_t>(mIndex + n)); }
+
+	iterator& operator++() { ++mIndex; return *this; }
+	iterator operator++(int) { auto tmp = *this; ++mIndex; return tmp; }
+	iterator& operator--() { --mIndex; return *this; }
+	iterator operator--(int) { auto tmp = *this; --mIndex; return tmp; }
+	iterator& operator+=(const difference_type n) { mIndex += n; return *this; }
+	iterator& operator-=(const difference_type n) { mIndex -= n; return *this; }
+	iterator operator+(const difference_type n) const { return iterator(mArray, mIndex + n); }
+	friend iterator operator+(const difference_type n, const iterator& it) { return it + n; }
+	iterator operator-(const difference_type n) const { return iterator(mArray, mIndex - n); }
+	difference_type operator-(const iterator& other) const { return mIndex - other.mIndex; }
+
+	bool operator==(const iterator& other) const { return mIndex == other.mIndex; }
+	bool operator!=(const iterator& other) const { return mIndex != other.mIndex; }
+	bool operator<(const iterator& other) const { return mIndex < other.mIndex; }
+	bool operator>(const iterator& other) const { return mIndex > other.mIndex; }
+	bool operator<=(const iterator& other) const { return mIndex <= other.mIndex; }
+	bool operator>=(const iterator& other) const { return mIndex >= other.mIndex; }
+};
+
+
+inline SortingDataArray::iterator SortingDataArray::begin()
+{
+	return iterator(this, 0);
+}
+
+inline SortingDataArray::iterator SortingDataArray::end()
+{
+	return iterator(this, static_cast<std::ptrdiff_t>(mSize));
+}
+
+inline SortingDataArray::reference SortingDataArray::operator[](const size_t index)
+{
+	return reference(this, index);
+}
@@ -0,0 +1,341 @@
+/**
+* microbench.cpp
+* @author: Kevin German
+*
+* Microbenchmarks of the sort.h building blocks against their std:: equivalents. Separate executable without SDL:
+*   g++ -std=c++17 -O2 -pthread -I.. microbench.cpp ../SortingData.cpp ../RuntimeSettings.cpp ../SortControl.cpp -o microbench
+* Usage: microbench [filter] [min. time per measurement in s (default 0.2)]
+**/
+#include "sort.h"
+#include "SortingData.h"
+#include "RuntimeSettings.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	/**
+	* @brief 64 byte record, the key is compared and the payload is moved with it
+	**/
+	struct Record64
+	{
+		int key{ 0 };
+		char payload[60]{};
+
+		Record64() = default;
+		explicit Record64(const int k) : key(k) {}
+		bool operator<(const Record64& other) const { return key < other.key; }
+	};
+
+	/**
+	* @brief loop state of one measurement (Google Benchmark style). Only the time between resume() and pause() is measured
+	**/
+	class State
+	{
+		size_t mSize;
+		size_t mIterations{ 0 };
+		size_t mMaxIterations;
+		size_t mItems{ 0 };
+		Clock::duration mElapsed{};
+		Clock::time_point mStart;
+		bool mRunning{ false };
+
+	public:
+		State(const size_t size, const size_t maxIterations) : mSize(size), mMaxIterations(maxIterations) {}
+
+		size_t size() const { return mSize; }
+		Clock::duration elapsed() const { return mElapsed; }
+		size_t items() const { return mItems; }
+
+		/**
+		* @brief for (; state.keep_running();) { ... }
+		* @return false after the requested number of iterations
+		**/
+		bool keep_running()
+		{
+			if (mIterations == mMaxIterations)
+			{
+				pause();
+				return false;
+			}
+			if (mIterations++ == 0)
+				resume();
+			return true;
+		}
+
+		void pause()
+		{
+			if (mRunning)
+				mElapsed += Clock::now() - mStart;
+			mRunning = false;
+		}
+
+		void resume()
+		{
+			mRunning = true;
+			mStart = Clock::now();
+		}
+
+		/**
+		* @brief adds processed items (elements, lookups, ...) of this iteration
+		* @return void
+		**/
+		void process(const size_t items) { mItems += items; }
+	};
+
+	/**
+	* @brief prevents the compiler from removing a computation whose result is unused (volatile read of the result)
+	**/
+	template <typename T>
+	void do_not_optimize(const T& value)
+	{
+		volatile char sink = *reinterpret_cast<const volatile char*>(&value);
+		static_cast<void>(sink);
+	}
+
+	template <typename T>
+	std::vector<T> random_input(const size_t n, const unsigned seed = 42)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_int_distribution<int> dist(0, 1 << 30);
+		std::vector<T> data;
+		data.reserve(n);
+		for (size_t i = 0; i < n; ++i)
+			data.emplace_back(dist(gen));
+		return data;
+	}
+
+	/**
+	* @brief number of small ranges which are processed per iteration, so the timer overhead does not dominate tiny sizes
+	**/
+	size_t batch_size(const size_t n)
+	{
+		return std::max<size_t>(1, 4096 / n);
+	}
+
+	//----kernels. each is called with the state of one measurement----
+
+	template <typename T, bool Std>
+	void bench_partition(State& state)
+	{
+		const auto input = random_input<T>(state.size());
+		auto data = input;
+		while (state.keep_running())
+		{
+			state.pause();
+			data = input;
+			state.resume();
+			if (Std)
+			{
+				const auto& pivot = data.back();
+				do_not_optimize(std::partition(data.begin(), std::prev(data.end()), [&pivot](const T& x) { return x < pivot; }));
+			}
+			else
+			{
+				do_not_optimize(sort::partition(data.begin(), std::prev(data.end()), std::less<>()));
+			}
+			state.process(data.size());
+		}
+	}
+
+	template <typename T, bool Std>
+	void bench_median_of_three(State& state)
+	{
+		const auto data = random_input<T>(state.size());
+		while (state.keep_running())
+		{
+			for (auto it = data.begin(); std::distance(it, data.end()) >= 3; it += 3)
+			{
+				if (Std)
+					do_not_optimize(std::max(std::min(it[0], it[1]), std::min(std::max(it[0], it[1]), it[2])));
+				else
+					do_not_optimize(sort::median_of_three(it, it + 1, it + 2, std::less<>()));
+			}
+			state.process(data.size() / 3);
+		}
+	}
+
+	template <typename T, bool Std>
+	void bench_inplace_merge(State& state)
+	{
+		auto input = random_input<T>(state.size());
+		const auto mid = input.size() / 2;
+		std::sort(input.begin(), std::next(input.begin(), mid));
+		std::sort(std::next(input.begin(), mid), input.end());
+		auto data = input;
+		while (state.keep_running())
+		{
+			state.pause();
+			data = input;
+			state.resume();
+			if (Std)
+				std::inplace_merge(data.begin(), std::next(data.begin(), mid), data.end());
+			else
+				sort::inplace_merge(data.begin(), std::next(data.begin(), mid), data.end(), std::less<>());
+			state.process(data.size());
+		}
+	}
+
+	template <typename T, bool Std>
+	void bench_binary_search(State& state)
+	{
+		auto data = random_input<T>(state.size());
+		std::sort(data.begin(), data.end());
+		const auto keys = random_input<T>(1024, 7);
+		while (state.keep_running())
+		{
+			for (auto& key : keys)
+			{
+				if (Std)
+					do_not_optimize(std::binary_search(data.begin(), data.end(), key));
+				else
+					do_not_optimize(sort::binary_search(data.begin(), data.end(), key, std::less<>()));
+			}
+			state.process(keys.size());
+		}
+	}
+
+	template <typename T, bool Std>
+	void bench_verify(State& state)
+	{
+		auto data = random_input<T>(state.size());
+		std::sort(data.begin(), data.end());
+		while (state.keep_running())
+		{
+			if (Std)
+				do_not_optimize(std::is_sorted(data.begin(), data.end()));
+			else
+				do_not_optimize(sort::verifiy_sort_order(data.begin(), data.end(), std::less<>()));
+			state.process(data.size());
+		}
+	}
+
+	template <typename T, bool Std>
+	void bench_leaf_sort(State& state)
+	{
+		const auto n = state.size();
+		const auto batch = batch_size(n);
+		const auto input = random_input<T>(n * batch);
+		auto data = input;
+		while (state.keep_running())
+		{
+			state.pause();
+			data = input;
+			state.resume();
+			for (auto first = data.begin(); first != data.end(); first += n)
+			{
+				if (Std)
+					std::sort(first, first + n);
+				else
+					sort::insertionsort_leaf(first, first + n, std::less<>());
+			}
+			state.process(data.size());
+		}
+	}
+
+	template <typename T, bool Std>
+	void bench_insertionsort(State& state)
+	{
+		const auto n = state.size();
+		const auto batch = batch_size(n);
+		const auto input = random_input<T>(n * batch);
+		auto data = input;
+		while (state.keep_running())
+		{
+			state.pause();
+			data = input;
+			state.resume();
+			for (auto first = data.begin(); first != data.end(); first += n)
+			{
+				if (Std)
+					std::sort(first, first + n);
+				else
+					sort::insertionsort(first, first + n, std::less<>());
+			}
+			state.process(data.size());
+		}
+	}
+
+	/**
+	* @brief one primitive for one element type: sort.h kernel, std:: kernel and the sizes to measure
+	**/
+	struct Primitive
+	{
+		std::string name;
+		std::string type;
+		std::vector<size_t> sizes;
+		void (*ours)(State&);
+		void (*std)(State&);
+	};
+
+	template <typename T>
+	void add_primitives(std::vector<Primitive>& primitives, const std::string& type)
+	{
+		const std::vector<size_t> large = { 256, 4096, 65536, 1048576 };
+		const std::vector<size_t> small = { 4, 8, 16, 32, 64 };
+		primitives.push_back({ "partition", type, large, bench_partition<T, false>, bench_partition<T, true> });
+		primitives.push_back({ "median_of_three", type, { 3072 }, bench_median_of_three<T, false>, bench_median_of_three<T, true> });
+		primitives.push_back({ "inplace_merge", type, { 256, 4096 }, bench_inplace_merge<T, false>, bench_inplace_merge<T, true> });	//sort::inplace_merge is O(n^2)
+		primitives.push_back({ "binary_search", type, large, bench_binary_search<T, false>, bench_binary_search<T, true> });
+		primitives.push_back({ "verifiy_sort_order", type, large, bench_verify<T, false>, bench_verify<T, true> });
+		primitives.push_back({ "insertionsort_leaf", type, small, bench_leaf_sort<T, false>, bench_leaf_sort<T, true> });
+		primitives.push_back({ "insertionsort", type, small, bench_insertionsort<T, false>, bench_insertionsort<T, true> });
+	}
+
+	/**
+	* @brief runs the kernel with growing iteration counts until one measurement takes at least minTime
+	* @return ns per processed item
+	**/
+	double measure(void (*kernel)(State&), const size_t size, const double minTime)
+	{
+		for (size_t iterations = 1;; )
+		{
+			State state(size, iterations);
+			kernel(state);
+			const std::chrono::duration<double> elapsed = state.elapsed();
+			if (elapsed.count() >= minTime || iterations >= 1000000000)
+				return state.items() != 0 ? elapsed.count() * 1e9 / static_cast<double>(state.items()) : 0.0;
+			//estimate the iterations for minTime, grow at least 2x and at most 10x per step
+			const auto factor = elapsed.count() > 0.0 ? 1.4 * minTime / elapsed.count() : 10.0;
+			iterations = static_cast<size_t>(static_cast<double>(iterations) * std::min(10.0, std::max(2.0, factor)));
+		}
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	const std::string filter = argc > 1 ? argv[1] : "";
+	const auto minTime = argc > 2 ? std::atof(argv[2]) : 0.2;
+
+	//SortingData without artificial delays
+	set_runtime_settings({ std::chrono::nanoseconds(0), std::chrono::nanoseconds(0) });
+
+	std::vector<Primitive> primitives;
+	add_primitives<int>(primitives, "int");
+	add_primitives<SortingData>(primitives, "SortingData");
+	add_primitives<Record64>(primitives, "Record64");
+
+	std::cout << std::left << std::setw(20) << "primitive" << std::setw(13) << "type" << std::right << std::setw(9) << "n"
+		<< std::setw(16) << "sort.h ns/item" << std::setw(16) << "std ns/item" << std::setw(10) << "ratio" << "\n";
+	for (const auto& primitive : primitives)
+	{
+		if (!filter.empty() && (primitive.name + "/" + primitive.type).find(filter) == std::string::npos)
+			continue;
+		for (const auto size : primitive.sizes)
+		{
+			const auto ours = measure(primitive.ours, size, minTime);
+			const auto reference = measure(primitive.std, size, minTime);
+			std::cout << std::left << std::setw(20) << primitive.name << std::setw(13) << primitive.type << std::right << std::setw(9) << size
+				<< std::fixed << std::setprecision(3) << std::setw(16) << ours << std::setw(16) << reference
+				<< std::setw(10) << (reference > 0.0 ? ours / reference : 0.0) << "\n" << std::defaultfloat;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,104 @@
+/**
+* regression.cpp
+* @author: Kevin German
+*
+* Regression checks of the sort.h templates on inputs which once broke them. Separate executable without SDL, build it with the
+* checked standard library so out of range iterators abort instead of reading neighbouring memory:
+*   g++ -std=c++17 -O1 -D_GLIBCXX_DEBUG -pthread -I.. regression.cpp -o regression
+* Usage: regression (exit code 1 if a check failed)
+**/
+#include "sort.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace
+{
+	auto failures = 0;
+
+	void check(const bool ok, const std::string& name)
+	{
+		std::cout << (ok ? "ok      " : "FAILED  ") << name << "\n";
+		if (!ok)
+			++failures;
+	}
+
+	/**
+	* @brief merges data[0, mid) and data[mid, size) with _merge_runs and compares the result with std::merge
+	* @return true if the result is sorted and stable
+	**/
+	bool merge_matches(const std::vector<int>& data, const size_t mid)
+	{
+		std::vector<std::pair<int, size_t>> merged;	//key, original position
+		for (size_t i = 0; i < data.size(); ++i)
+			merged.emplace_back(data[i], i);
+		auto expected = merged;
+		std::inplace_merge(expected.begin(), expected.begin() + mid, expected.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+		std::vector<std::pair<int, size_t>> buffer;
+		auto minGallop = sort::minGallopLength;
+		sort::_merge_runs(merged.begin(), merged.begin() + mid, merged.end(), [](const auto& a, const auto& b) { return a.first < b.first; },
+			buffer, minGallop);
+		return merged == expected;
+	}
+
+	std::vector<int> random_input(const size_t n, const unsigned seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_int_distribution<int> dist(0, 1 << 30);
+		std::vector<int> data(n);
+		for (auto& key : data)
+			key = dist(gen);
+		return data;
+	}
+}
+
+int main()
+{
+	//the right run has exactly minGallopLength elements, all smaller than the last left element: it is exhausted by single steps
+	//just as galloping starts (_merge_lo read *end)
+	std::vector<int> lo = { 0, 100 };
+	for (auto i = 1; i <= sort::minGallopLength; ++i)
+		lo.push_back(i);
+	check(merge_matches(lo, 2), "_merge_lo: right run exhausted when galloping starts");
+
+	//mirror case from the back (_merge_hi)
+	std::vector<int> hi;
+	for (auto i = 1; i <= sort::minGallopLength; ++i)
+		hi.push_back(i + 1);
+	hi.push_back(1);
+	hi.push_back(100);
+	check(merge_matches(hi, sort::minGallopLength), "_merge_hi: left run exhausted when galloping starts");
+
+	//third <= second <= first with third equal to the median (5, 3, 3) takes the three-way partition
+	std::vector<int> pivots = { 5, 0, 3, 0, 3 };
+	const auto equal = sort::_quicksort_partition(pivots.begin(), pivots.end(), std::less<>());
+	check(std::distance(equal.first, equal.second) == 2 && std::is_sorted(pivots.begin(), pivots.end()), "_quicksort_partition: duplicate of the median last");
+
+	//random inputs whose merges ran into the case above
+	for (const size_t n : { 1319, 4096, 100000 })
+	{
+		for (unsigned seed = 1; seed <= 4; ++seed)
+		{
+			const auto input = random_input(n, seed);
+			auto expected = input;
+			std::sort(expected.begin(), expected.end());
+			const auto suffix = " n=" + std::to_string(n) + " seed=" + std::to_string(seed);
+
+			auto data = input;
+			sort::powersort(data.begin(), data.end(), std::less<>());
+			check(data == expected, "powersort" + suffix);
+
+			data = input;
+			sort::multiway_mergesort(data.begin(), data.end(), std::less<>(), 4);
+			check(data == expected, "multiway_mergesort" + suffix);
+		}
+	}
+
+	std::cout << (failures == 0 ? "all checks passed" : std::to_string(failures) + " checks failed") << "\n";
+	return failures == 0 ? 0 : 1;
+}
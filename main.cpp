@@ -7,39 +7,75 @@
 #include <thread>
 #include <iostream>
 #include <fstream>
+#include <atomic>
+#include <string>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+#include <cstdint>
 #include "settings.h"
 #include "SortingData.h"
+#include "SortingDataArray.h"
+#include "RuntimeSettings.h"
+#include "SortControl.h"
+#include "CommandQueue.h"
+#include "AlgorithmRegistry.h"
 #include "sort.h"
+#include "ExternalSort.h"
+#include "Benchmark.h"
+#include "PerfCounters.h"
+#include "Renderer.h"
+#include "Recorder.h"
 
 //-------Prototypes-------
 void init_settings(const int argc, char** argv);
 void close_system();
 void print_controls();
-void init_data(std::vector<SortingData>& data);
-void keyboard_event(const SDL_KeyboardEvent* type, std::vector<SortingData>& data);
-void thread_drawing(std::vector<SortingData>* data);
-void thread_sorting(std::vector<SortingData>* data);
+void init_data(SortingDataArray& data);
+void keyboard_event(const SDL_KeyboardEvent* type);
+bool key_to_command(SDL_Keycode key, SortCommand& command);
+void change_speed(bool faster);
+void thread_drawing(SortingDataArray* data);
+void set_draw_color(std::uint32_t color);
+void draw_rects(SortingDataArray& data, SlotTracker& slots);
+void draw_texture(SortingDataArray& data, SDL_Texture* texture, FrameBuffer& frame);
+void thread_sorting(SortingDataArray* data);
+void run_sort(const AlgorithmInfo& algorithm, SortingDataArray& data, sort::ScratchArena& scratch);
 int init_system();
+int run_external_sort(const int argc, char** argv);
+int run_batch(const int argc, char** argv);
+int run_scaling_sweep(const int argc, char** argv);
+int run_recording(const int argc, char** argv);
 //------Variables---------
 auto assignmentDelay = defaultAssignmentDelay;
 auto compareDelay = defaultCompareDelay;
 auto numberOfElements = defaultNumberOfElements;
-auto currentSortingAlgorithm = sort::SortingAlgorithm::none;
-auto isRunning = true;
-bool sortingDisabled = false;
+std::atomic<bool> isRunning{ true };
+CommandQueue commands;	//event loop -> thread_sorting
 //------SDL variables-----
 SDL_Window* window = nullptr;
 SDL_Renderer* renderer = nullptr;
 auto elementWidth = defaultScreenWidth / numberOfElements;
 auto screenWidth = defaultScreenWidth;
 auto screenHeight = defaultScreenHeight;
-auto maxThreads = defaultMaxThreads;
+std::atomic<int> maxThreads{ defaultMaxThreads };
+std::atomic<bool> streamingRenderer{ false };	//true: framebuffer + streaming texture, false: one rect per element/column
 
 int main(const int argc, char** argv)
 {
+	if (argc > 1 && std::string(argv[1]) == "--external-sort")
+		return run_external_sort(argc, argv);
+	if (argc > 1 && (std::string(argv[1]) == "--script" || std::string(argv[1]) == "--run"))
+		return run_batch(argc, argv);
+	if (argc > 1 && std::string(argv[1]) == "--scaling")
+		return run_scaling_sweep(argc, argv);
+	if (argc > 1 && std::string(argv[1]) == "--record")
+		return run_recording(argc, argv);
+
 	init_settings(argc, argv);
+	set_runtime_settings({ compareDelay, assignmentDelay });
 	//init
-	std::vector<SortingData> data(numberOfElements);
+	SortingDataArray data(numberOfElements);
 	init_data(data);
 	if (init_system())
 		return -1;
@@ -50,25 +86,24 @@ int main(const int argc, char** argv)
 	std::thread drawingThread(thread_drawing, &data);
 	std::thread sortingThread(thread_sorting, &data);
 
-	//handle events
+	//handle events. blocks until input arrives, commands are handed to the sort executor immediately
 	while (isRunning)
 	{
 		SDL_Event event;
-		while (SDL_PollEvent(&event))
+		if (!SDL_WaitEventTimeout(&event, eventWaitTimeout))
+			continue;
+		switch (event.type)
 		{
-			switch (event.type)
-			{
-			case SDL_KEYDOWN:
-				keyboard_event(&event.key, data);
-				break;
-			case SDL_QUIT:
-				sortingDisabled = true;
-				isRunning = false;
-			default:
-				break;
-			}
+		case SDL_KEYDOWN:
+			keyboard_event(&event.key);
+			break;
+		case SDL_QUIT:
+			commands.clear();
+			commands.push({ SortCommand::Type::quit });
+			isRunning = false;
+		default:
+			break;
 		}
-		std::this_thread::sleep_for(std::chrono::milliseconds(50));
 	}
 
 	//wait for threads
@@ -82,172 +117,160 @@ int main(const int argc, char** argv)
 }
 
 
-void thread_drawing(std::vector<SortingData>* data)
+void thread_drawing(SortingDataArray* data)
+{
+	//level of detail: with more elements than pixel columns every column shows the aggregate of its elements
+	SlotTracker slots;
+	FrameBuffer frame(screenWidth, screenHeight, defaultRenderThreads);
+	auto* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, screenWidth, screenHeight);
+	if (texture == nullptr)
+		std::cout << "Streaming texture not available: " << SDL_GetError() << "\n";
+
+	while (isRunning)
+	{
+		//both renderers take the dirty bits, the inactive one redraws everything when it is activated
+		if (streamingRenderer && texture != nullptr)
+		{
+			draw_texture(*data, texture, frame);
+			slots.invalidate();
+		}
+		else
+		{
+			draw_rects(*data, slots);
+			frame.invalidate();
+		}
+		SDL_RenderPresent(renderer);
+		std::this_thread::yield();
+	}
+	if (texture != nullptr)
+		SDL_DestroyTexture(texture);
+}
+
+void draw_rects(SortingDataArray& data, SlotTracker& slots)
 {
 	SDL_Rect rect;
 	rect.y = screenHeight;
 	rect.w = elementWidth;
 
-	while (isRunning)
-	{
-		//clear screen
-		SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
-		SDL_RenderClear(renderer);
-		//draw each element
-		SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+	//clear screen
+	set_draw_color(backgroundColor);
+	SDL_RenderClear(renderer);
 
-		auto elementPos = 0;
-		for (auto& element : *data)
+	//only the dirty slots are aggregated again, all slots are drawn from their stored state
+	slots.collect(data, std::min<size_t>(data.size(), screenWidth));
+	for (const auto s : slots.dirty())
+		slots.aggregate(data, s);
+	slots.finish();
+
+	//each slot: bar up to the mean key, the range up to the max key of aggregated columns is drawn dimmed
+	const auto verificationEnabled = slots.verificationEnabled();
+	for (size_t s = 0; s < slots.size(); ++s)
+	{
+		const auto& slot = slots[s];
+		rect.x = static_cast<int>(s * elementWidth);
+		if (slot.maxKey != slot.meanKey)
 		{
-			if (!element.verificationEnabled())
-			{
-				if (element.compared())
-					SDL_SetRenderDrawColor(renderer, 194, 24, 7, SDL_ALPHA_OPAQUE);
-				else if (element.assigned())
-					SDL_SetRenderDrawColor(renderer, 90, 24, 7, SDL_ALPHA_OPAQUE);
-				else
-					SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
-			}
-			else
-			{
-				if (element.compared())
-					SDL_SetRenderDrawColor(renderer, 0, 160, 0, SDL_ALPHA_OPAQUE);
-				else
-					SDL_SetRenderDrawColor(renderer, 194, 24, 7, SDL_ALPHA_OPAQUE);
-			}
-			rect.h = -element.mKey;
-			rect.x = (elementPos++) * elementWidth;
+			rect.h = -slot.maxKey;
+			set_draw_color(rangeColor);
 			SDL_RenderFillRect(renderer, &rect);
 		}
-		SDL_RenderPresent(renderer);
-		std::this_thread::yield();
+		set_draw_color(element_color(verificationEnabled ? slot.allCompared : slot.compared, slot.assigned, verificationEnabled));
+		rect.h = -slot.meanKey;
+		SDL_RenderFillRect(renderer, &rect);
 	}
 }
 
-void thread_sorting(std::vector<SortingData>* data)
+void draw_texture(SortingDataArray& data, SDL_Texture* texture, FrameBuffer& frame)
 {
-	while (isRunning)
+	//only the changed columns are rasterized and uploaded, the texture keeps the rest of the last frame
+	const auto changed = frame.update(data);
+	if (changed.first != changed.second)
 	{
-		if (currentSortingAlgorithm != sort::SortingAlgorithm::none)
+		SDL_Rect rect;
+		rect.x = static_cast<int>(changed.first);
+		rect.y = 0;
+		rect.w = static_cast<int>(changed.second - changed.first);
+		rect.h = static_cast<int>(frame.height());
+		void* pixels = nullptr;
+		auto pitch = 0;
+		//the locked pixels are write only, so the whole locked rect is copied from the framebuffer
+		if (SDL_LockTexture(texture, &rect, &pixels, &pitch) == 0)
 		{
-			sortingDisabled = false;
-			//start timer here for rough measurement 
-			const auto start = std::chrono::high_resolution_clock::now();
-			try
-			{
-				switch (currentSortingAlgorithm)
-				{
-				case sort::SortingAlgorithm::cyclesort:
-					std::cout << "Cyclesort started...\n";
-					sort::cyclesort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::bubblesort:
-					std::cout << "Bubblesort started...\n";
-					sort::bubblesort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::bubblesortrc:
-					std::cout << "Bubblesort recursivly started...\n";
-					sort::bubblesort_rc(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::stdsort:
-					std::cout << "std::sort started...\n";
-					std::sort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::shellsort:
-					std::cout << "Shellsort started...\n";
-					sort::shellsort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::combsort:
-					std::cout << "Combsort started...\n";
-					sort::combsort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::gnomesort:
-					std::cout << "Gnomesort started...\n";
-					sort::gnomesort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::gnomesort2:
-					std::cout << "Gnomesort2 started...\n";
-					sort::gnomesort2(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::radixsort:
-					std::cout << "Radixsort started...\n";
-					sort::radixsort(data->begin(), data->end(), 13);
-					break;
-				case sort::SortingAlgorithm::radixsortslow:
-					std::cout << "Slow radixsort started...\n";
-					sort::radixsort_slow(data->begin(), data->end(), 13);
-					break;
-				case sort::SortingAlgorithm::radixsortipis:
-					std::cout << "Inplace Radixsort with insertionsort started...\n";
-					sort::radixsort_ip_is(data->begin(), data->end(), 13, std::less<>(), maxThreads);
-					break;
-				case sort::SortingAlgorithm::insertionsort:
-					std::cout << "Insertionsort started...\n";
-					sort::insertionsort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::insertionsortbinsearch:
-					std::cout << "Insertionsort with binary search started...\n";
-					sort::insertionsort_binsearch(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::selectionsort:
-					std::cout << "Selectionsort started...\n";
-					sort::selectionsort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::bogosort:
-					std::cout << "Bogosort started...\n";
-					sort::bogosort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::bozosort:
-					std::cout << "Bozosort started...\n";
-					sort::bozosort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::oddevensort:
-					std::cout << "Odd-even-sort started...\n";
-					sort::odd_even_sort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::shakersort:
-					std::cout << "Shakersort started...\n";
-					sort::shakersort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::quicksort:
-					std::cout << "Quicksort started...\n";
-					sort::quicksort(data->begin(), data->end(), std::less<>(), maxThreads);
-					break;
-				case sort::SortingAlgorithm::mergesort:
-					std::cout << "Mergesort started...\n";
-					sort::mergesort(data->begin(), data->end(), std::less<>(), maxThreads);
-					break;
-				case sort::SortingAlgorithm::heapsort:
-					std::cout << "Heapsort started...\n";
-					sort::heapsort(data->begin(), data->end());
-					break;
-				case sort::SortingAlgorithm::introsort:
-					std::cout << "Introsort started...\n";
-					sort::introsort(data->begin(), data->end(), std::less<>(), maxThreads);
-					break;
-				case sort::SortingAlgorithm::stdstablesort:
-					std::cout << "std::stablesort started...\n";
-					std::stable_sort(data->begin(), data->end());
-					break;
-				default:
-					break;
-				}
-				std::cout << "Sort finished. ";
-			} 
-			catch (std::exception & e)
-			{
-				std::cout << e.what();	//user input will interrupt the sorting process
-			}
-			const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
-			currentSortingAlgorithm = sort::SortingAlgorithm::none;
-			sortingDisabled = false;
-			std::cout << "Elapsed Time:\t" << elapsed.count() << " s\n";
+			const auto bytes = static_cast<size_t>(rect.w) * sizeof(std::uint32_t);
+			for (size_t y = 0; y < frame.height(); ++y)
+				std::memcpy(static_cast<char*>(pixels) + y * pitch, frame.pixels() + y * frame.width() + changed.first, bytes);
+			SDL_UnlockTexture(texture);
+		}
+	}
+	SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+}
+
+void set_draw_color(const std::uint32_t color)
+{
+	SDL_SetRenderDrawColor(renderer, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, SDL_ALPHA_OPAQUE);
+}
+
+void thread_sorting(SortingDataArray* data)
+{
+	//executor: runs the queued commands one after another. The scratch memory is reused by all sorts
+	sort::ScratchArena scratch;
+	for (auto command = commands.pop(); command.type != SortCommand::Type::quit; command = commands.pop())
+	{
+		switch (command.type)
+		{
+		case SortCommand::Type::sort:
+			if (const auto algorithm = find_algorithm(command.algorithm))
+				run_sort(*algorithm, *data, scratch);
+			break;
+		case SortCommand::Type::init:
+			init_data(*data);
+			break;
+		case SortCommand::Type::inverse:
+			sort::inverse_order(data->begin(), data->end());
+			std::cout << "Order inversed!\n";
+			break;
+		case SortCommand::Type::verify:
+			//enable verification mode, this is used for drawing correctly sorted values in green
+			data->enableVerification(true);
+			if (sort::verifiy_sort_order(data->begin(), data->end(), std::less<>()))
+				std::cout << "Sorted!\n";
+			else
+				std::cout << "Not sorted\n";
+			break;
+		default:
+			break;
 		}
-		std::this_thread::sleep_for(std::chrono::milliseconds(100));
 	}
 }
 
-void init_data(std::vector<SortingData>& data)
+void run_sort(const AlgorithmInfo& algorithm, SortingDataArray& data, sort::ScratchArena& scratch)
+{
+	//sized before the timer, only algorithms with a buffer use it
+	if (algorithm.scratch)
+		scratch.reserve(data.size() * sizeof(SortingData));
+	std::cout << algorithm.name << " started...\n";
+	PerfCounters counters;
+	//start timer here for rough measurement 
+	counters.start();
+	const auto start = std::chrono::high_resolution_clock::now();
+	try
+	{
+		algorithm.sortData(data.begin(), data.end(), { maxThreads, sort_stop_token(), &scratch });
+		counters.stop();
+		//user input cancels the sorting process, the algorithm finishes without delays
+		std::cout << (sort_cancelled() ? "Sort interrupted by user input. " : "Sort finished. ");
+	} 
+	catch (std::exception & e)
+	{
+		std::cout << e.what();
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+	std::cout << "Elapsed Time:\t" << elapsed.count() << " s\n";
+	if (counters.available())
+		counters.print(std::cout);
+}
+
+void init_data(SortingDataArray& data)
 {
 	//init seed & rng
 	std::random_device seed;
@@ -255,125 +278,113 @@ void init_data(std::vector<SortingData>& data)
 	std::uniform_int_distribution<int> dist(0, screenHeight);
 
 	//fill with random values
-	for (auto& i : data)
-		i.mKey = dist(gen);
+	for (size_t i = 0; i < data.size(); ++i)
+		data.setKey(i, dist(gen));
 
-	for (auto& i : data)
-	{
-		i.enableVerification(false); //disable slow comparison 
-		i.setDelay(compareDelay, assignmentDelay);
-	}
+	data.enableVerification(false); //disable slow comparison 
 }
 
-void keyboard_event(const SDL_KeyboardEvent* type, std::vector<SortingData>& data)
+void keyboard_event(const SDL_KeyboardEvent* type)
 {
-	sortingDisabled = true;
+	//held keys repeat their keydown, they must not stop and restart the running sort
+	if ((*type).repeat != 0)
+		return;
+	//speed changes, pause and thread count apply immediately. modifiers alone are no command and keep the running sort
 	switch ((*type).keysym.sym)
 	{
-	case SDLK_0:
-		init_data(data);
-		break;
-	case SDLK_1:
-		currentSortingAlgorithm = sort::SortingAlgorithm::stdsort;
-		break;
-	case SDLK_2:
-		currentSortingAlgorithm = sort::SortingAlgorithm::bubblesort;
-		break;
-	case SDLK_3:
-		currentSortingAlgorithm = sort::SortingAlgorithm::bubblesortrc;
-		break;
-	case SDLK_4:
-		currentSortingAlgorithm = sort::SortingAlgorithm::insertionsort;
-		break;
-	case SDLK_5:
-		currentSortingAlgorithm = sort::SortingAlgorithm::insertionsortbinsearch;
-		break;
-	case SDLK_6:
-		currentSortingAlgorithm = sort::SortingAlgorithm::selectionsort;
-		break;
-	case SDLK_7:
-		currentSortingAlgorithm = sort::SortingAlgorithm::gnomesort;
-		break;
-	case SDLK_8:
-		currentSortingAlgorithm = sort::SortingAlgorithm::gnomesort2;
-		break;
-	case SDLK_9:
-		currentSortingAlgorithm = sort::SortingAlgorithm::cyclesort;
-		break;
-	case SDLK_q:
-		currentSortingAlgorithm = sort::SortingAlgorithm::shellsort;
-		break;
-	case SDLK_w:
-		currentSortingAlgorithm = sort::SortingAlgorithm::combsort;
-		break;
-	case SDLK_e:
-		currentSortingAlgorithm = sort::SortingAlgorithm::oddevensort;
-		break;
-	case SDLK_r:
-		currentSortingAlgorithm = sort::SortingAlgorithm::shakersort;
-		break;
-	case SDLK_t:
-		currentSortingAlgorithm = sort::SortingAlgorithm::radixsort;
-		break;
-	case SDLK_z:
-		currentSortingAlgorithm = sort::SortingAlgorithm::radixsortslow;
-		break;
-	case SDLK_u:
-		currentSortingAlgorithm = sort::SortingAlgorithm::radixsortipis;
-		break;
-	case SDLK_i:
-		currentSortingAlgorithm = sort::SortingAlgorithm::bogosort;
-		break;
-	case SDLK_o:
-		currentSortingAlgorithm = sort::SortingAlgorithm::bozosort;
-		break;
-	case SDLK_p:
-		currentSortingAlgorithm = sort::SortingAlgorithm::quicksort;
-		break;
-	case SDLK_a:
-		currentSortingAlgorithm = sort::SortingAlgorithm::mergesort;
-		break;
-	case SDLK_s:
-		currentSortingAlgorithm = sort::SortingAlgorithm::heapsort;
-		break;
-	case SDLK_d:
-		currentSortingAlgorithm = sort::SortingAlgorithm::introsort;
-		break;
-	case SDLK_f:
-		currentSortingAlgorithm = sort::SortingAlgorithm::stdstablesort;
-		break;
-	case SDLK_x: //inverse order
-		sort::inverse_order(data.begin(), data.end());
-		std::cout << "Order inversed!\n";
-		break;
-	case SDLK_v:
-		//verify order
-		//enable verification mode, this is used for drawing correctly sorted values in green
-		for (auto& i : data)
-			i.enableVerification(true);
-
-		if (sort::verifiy_sort_order(data.begin(), data.end()))
-			std::cout << "Sorted!\n";
-		else
-			std::cout << "Not sorted\n";
-		break;
+	case SDLK_LSHIFT:
+	case SDLK_RSHIFT:
+	case SDLK_LCTRL:
+	case SDLK_RCTRL:
+	case SDLK_LALT:
+	case SDLK_RALT:
+	case SDLK_LGUI:
+	case SDLK_RGUI:
+		return;
+	case SDLK_SPACE:
+		pause_sort(!sort_paused());
+		std::cout << (sort_paused() ? "Paused\n" : "Resumed\n");
+		return;
+	case SDLK_PLUS:
+	case SDLK_EQUALS:	//'+' is Shift+'=' on most layouts
+	case SDLK_KP_PLUS:
+		change_speed(true);
+		return;
+	case SDLK_MINUS:
+	case SDLK_KP_MINUS:
+		change_speed(false);
+		return;
 	case SDLK_b:
 		std::cout << "Max. threads increased: " << ++maxThreads << "\n";
-		break;
+		return;
 	case SDLK_n:
 		if (maxThreads != 0)
-		{
-			--maxThreads;
-			std::cout << "Max. threads decreased: " << maxThreads << "\n";
-		}
+			std::cout << "Max. threads decreased: " << --maxThreads << "\n";
 		else
-		{
 			std::cout << "Max. threads is already 0\n";
-		}
+		return;
+	case SDLK_m:
+		streamingRenderer = !streamingRenderer;
+		std::cout << (streamingRenderer ? "Streaming texture renderer\n" : "Rect renderer\n");
+		return;
+	default:
 		break;
+	}
+
+	SortCommand command;
+	const auto isCommand = key_to_command((*type).keysym.sym, command);
+	//shift queues the command behind the running one, otherwise the running sort is stopped
+	if (isCommand && ((*type).keysym.mod & KMOD_SHIFT))
+	{
+		commands.push(command);
+		return;
+	}
+	commands.clear();
+	if (isCommand)
+		commands.push(command);
+}
+
+bool key_to_command(const SDL_Keycode key, SortCommand& command)
+{
+	switch (key)
+	{
+	case SDLK_0:
+		command.type = SortCommand::Type::init;
+		return true;
+	case SDLK_x: //inverse order
+		command.type = SortCommand::Type::inverse;
+		return true;
+	case SDLK_v: //verify order
+		command.type = SortCommand::Type::verify;
+		return true;
 	default:
 		break;
 	}
+
+	const auto algorithm = find_algorithm_by_key(key);
+	if (!algorithm)
+		return false;
+	command.type = SortCommand::Type::sort;
+	command.algorithm = algorithm->id;
+	return true;
+}
+
+void change_speed(const bool faster)
+{
+	auto settings = runtime_settings();
+	if (faster)
+	{
+		settings.compareDelay /= 2;
+		settings.assignmentDelay /= 2;
+	}
+	else
+	{
+		//start from 100ns if the delays are 0
+		settings.compareDelay = std::max(settings.compareDelay * 2, std::chrono::nanoseconds(100));
+		settings.assignmentDelay = std::max(settings.assignmentDelay * 2, std::chrono::nanoseconds(100));
+	}
+	set_runtime_settings(settings);
+	std::cout << "Comparison delay: " << settings.compareDelay.count() << "ns, assignment delay: " << settings.assignmentDelay.count() << "ns\n";
 }
 
 int init_system()
@@ -477,7 +488,7 @@ void init_settings(const int argc, char** argv)
 	}
 
 	//----number of elements----
-	std::cout << "Number of elements (default " << defaultScreenWidth / 2 << " ): ";
+	std::cout << "Number of elements (default " << defaultScreenWidth / 2 << ", more than the screenwidth are drawn aggregated): ";
 	if (loadFromFile)
 	{
 		file >> numberOfElements;
@@ -487,12 +498,12 @@ void init_settings(const int argc, char** argv)
 	{
 		std::cin >> numberOfElements;
 	}
-	if (numberOfElements == 0 || numberOfElements > screenWidth)
+	if (numberOfElements == 0 || numberOfElements > maxNumberOfElements)
 	{
 		std::cout << "Invalid size. Default: " << defaultScreenWidth / 2 << " used\n";
 		numberOfElements = defaultScreenWidth / 2;
 	}
-	elementWidth = screenWidth / numberOfElements;
+	elementWidth = std::max<size_t>(1, screenWidth / numberOfElements);
 
 	//----assignmentdelay----
 	std::cout << "Assignment delay (default " << defaultAssignmentDelay.count() << "ns ): ";
@@ -529,41 +540,134 @@ void init_settings(const int argc, char** argv)
 		std::cout << "Invalid delay. Default: " << defaultCompareDelay.count() << " used\n";
 }
 
+int run_external_sort(const int argc, char** argv)
+{
+	if (argc < 4)
+	{
+		std::cout << "Usage: " << argv[0] << " --external-sort <input file> <output file> [memory budget in MiB] [temp directory]\n"
+			<< "Sorts a binary file of 32 bit integer keys which may be larger than the memory.\n";
+		return -1;
+	}
+
+	sort::ExternalSortSettings settings;
+	settings.maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	if (argc > 4)
+	{
+		const auto budget = std::atoll(argv[4]);
+		if (budget > 0)
+			settings.memoryBudget = static_cast<size_t>(budget) * 1024u * 1024u;
+		else
+			std::cout << "Invalid memory budget. Default: " << defaultExternalMemoryBudget / (1024u * 1024u) << " MiB used\n";
+	}
+	if (argc > 5)
+		settings.tempDirectory = argv[5];
+
+	const auto start = std::chrono::high_resolution_clock::now();
+	if (!sort::external_sort(argv[2], argv[3], settings))
+		return -1;
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+	std::cout << "External sort finished. Elapsed Time:\t" << elapsed.count() << " s\n";
+	return 0;
+}
+
+int run_batch(const int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::cout << "Usage: " << argv[0] << " --script <script file> [report file]\n"
+			<< "       " << argv[0] << " --run \"<commands>\" [report file]\n"
+			<< "Runs a benchmark script unattended, e.g. \"generate zipf 1e7; sort introsort threads=8; verify; repeat 10\"\n";
+		return -1;
+	}
+
+	std::string script = argv[2];
+	if (std::string(argv[1]) == "--script")
+	{
+		std::ifstream file(argv[2]);
+		if (!file)
+		{
+			std::cout << "Error: " << argv[2] << " not found!\n";
+			return -1;
+		}
+		script.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	return run_script(script, argc > 3 ? argv[3] : "");
+}
+
+int run_scaling_sweep(const int argc, char** argv)
+{
+	ScalingSettings settings;
+	if (argc < 3 || argc > 7)
+	{
+		std::cout << "Usage: " << argv[0] << " --scaling <csv file> [n (default " << settings.n << ")] [max. threads (default: hardware threads)] [repeats (default "
+			<< settings.repeats << ")] [distribution (default " << settings.distribution << ")]\n"
+			<< "Strong and weak scaling sweep of all parallel algorithms, writes speedup, efficiency and Karp-Flatt serial fraction as csv.\n";
+		return -1;
+	}
+	if (argc > 3)
+		settings.n = static_cast<size_t>(std::max(1.0, std::atof(argv[3])));
+	if (argc > 4)
+		settings.maxThreads = std::atoi(argv[4]);
+	if (argc > 5)
+		settings.repeats = std::atoi(argv[5]);
+	if (argc > 6)
+		settings.distribution = argv[6];
+	return run_scaling(settings, argv[2]);
+}
+
+int run_recording(const int argc, char** argv)
+{
+	RecordSettings settings;
+	if (argc < 4 || argc > 8)
+	{
+		std::cout << "Usage: " << argv[0] << " --record <y4m file> <algorithm name> [elements (default " << settings.numberOfElements << ")] [distribution (default "
+			<< settings.distribution << ")] [simulated us per frame (default " << std::chrono::duration_cast<std::chrono::microseconds>(settings.frameStep).count()
+			<< ")] [max. threads (default " << settings.maxThreads << ")]\n"
+			<< "Renders a sort without window into a " << settings.width << "x" << settings.height << " video at " << settings.fps << " fps, e.g. --record sort.y4m introsort 1e5\n";
+		return -1;
+	}
+	settings.algorithm = argv[3];
+	if (argc > 4)
+		settings.numberOfElements = static_cast<size_t>(std::max(1.0, std::min(std::atof(argv[4]), static_cast<double>(maxNumberOfElements))));
+	if (argc > 5)
+		settings.distribution = argv[5];
+	if (argc > 6)
+		settings.frameStep = std::chrono::microseconds(std::max(1, std::atoi(argv[6])));
+	if (argc > 7)
+		settings.maxThreads = std::atoi(argv[7]);
+	set_runtime_settings({ defaultCompareDelay, defaultAssignmentDelay });
+	return record(settings, argv[2]);
+}
+
 void print_controls()
 {
 	std::cout
 		<< "\n---------CONTROLS---------\n"
-		<< "0|random init data\n"
-		<< "1|std::sort (unstoppable)\n"
-		<< "2|bubblesort\n"
-		<< "3|bubblesort recursivly\n"
-		<< "4|insertionsort\n"
-		<< "5|insertionsort with binary search\n"
-		<< "6|selectionsort\n"
-		<< "7|gnomesort\n"
-		<< "8|gnomesort with jump(insertionsort variation)\n"
-		<< "9|cyclesort\n"
-		<< "Q|shellsort\n"
-		<< "W|combsort\n"
-		<< "E|odd-even-sort (2 threads)\n"
-		<< "R|shakersort\n"
-		<< "T|radixsort\n"
-		<< "Z|radixsort slow (copy instead of move operations used)\n"
-		<< "U|radixsort in-place & insertionsort (optional parallel)\n"
-		<< "I|bogosort\n"
-		<< "O|bozosort\n"
-		<< "P|quicksort (optional parallel)\n"
-		<< "A|mergesort (optional parallel)\n"
-		<< "S|heapsort\n"
-		<< "D|introsort (optional parallel)\n"
-		<< "F|std::stablesort\n"
+		<< "0|random init data\n";
+	for (const auto& algorithm : algorithms)
+	{
+		if (algorithm.key == '\0')
+			continue;
+		std::cout << static_cast<char>(std::toupper(algorithm.key)) << "|" << algorithm.name << " " << algorithm.complexity;
+		if (algorithm.stable || algorithm.parallel)
+			std::cout << " (" << (algorithm.stable ? "stable" : "") << (algorithm.stable && algorithm.parallel ? ", " : "") << (algorithm.parallel ? "optional parallel" : "") << ")";
+		std::cout << "\n";
+	}
+	std::cout
 		<< "X|reverse order\n"
 		<< "V|verify order\n"
 		<< "----Threads(default " << defaultMaxThreads << ")----\n"
 		<< "B|increase max. threads\n"
 		<< "N|decrease max. threads\n"
+		<< "----Rendering----\n"
+		<< "M|toggle streaming texture renderer\n"
+		<< "----Speed (while sorting)----\n"
+		<< "+|faster (halve delays)\n"
+		<< "-|slower (double delays)\n"
+		<< "Space|pause/resume\n"
 		<< "--------------------------\n"
-		<< "  Keypress stopps sort\n"
+		<< "Shift+key queues the command (e.g. P, Shift+A, Shift+V)\n"
+		<< "  Other keys stop sort\n"
 		<< "--------------------------\n"
 		<< std::endl;
 }
@@ -10,11 +10,23 @@ static constexpr auto defaultScreenWidth = 1200u;
 static constexpr auto defaultScreenHeight = 800u;
 //sort settings
 static constexpr size_t defaultNumberOfElements = 1200;
+static constexpr size_t maxNumberOfElements = 100000000;
+static constexpr size_t maxSamplesPerColumn = 64;	//keys per pixel column which are sampled for the bar if there are more elements than columns
+static constexpr size_t defaultRenderThreads = 4;	//threads which compose a frame of the framebuffer renderers
+static constexpr size_t minParallelComposePixels = 1 << 16;	//pixels per thread below which a frame is composed by one thread
 static constexpr std::chrono::nanoseconds defaultCompareDelay{ 500 };
 static constexpr std::chrono::nanoseconds defaultAssignmentDelay{ 2000 };
 static constexpr auto timeForVerification = 5;
 static constexpr auto defaultMaxThreads = 4;
 static constexpr auto configFileName = "config.txt";
+static constexpr auto eventWaitTimeout = 100;	//ms, upper bound for the event loop to notice shutdown
+//headless recording
+static constexpr std::chrono::nanoseconds defaultRecordFrameStep{ 50000 };	//simulated time (sum of the delays) per video frame
+static constexpr std::chrono::nanoseconds simulatedMoveTime{ 200 };	//simulated time of a move, moves have no delay in the live visualization
+static constexpr auto defaultRecordFps = 30;
+//external sort settings
+static constexpr size_t defaultExternalMemoryBudget = 256u * 1024u * 1024u;
+static constexpr size_t minExternalBlockSize = 256u * 1024u;	//smallest read/write block (bytes) used by the merge
 
 
 static enum {
@@ -7,6 +7,15 @@
 #include <random>
 #include <vector>
 #include <algorithm>
+#include <iterator>
+#include <memory>
+#include <cstring>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 namespace sort
 {
 	/**
@@ -37,7 +46,93 @@ namespace sort
 		mergesort,
 		heapsort,
 		introsort,
-		stdstablesort
+		stdstablesort,
+		powersort,
+		samplesort,
+		multiwaymergesort,
+		countingsort
+	};
+
+
+	/**
+	* @brief ranges smaller than this are sorted by insertionsort_leaf inside the recursive sorts
+	**/
+	static constexpr auto leafSortThreshold = 16;
+
+
+	/**
+	* @brief read only view of a StopSource (std::stop_token-style). A default constructed token never requests a stop
+	**/
+	class StopToken
+	{
+		const std::atomic<bool>* mStop = nullptr;
+
+	public:
+		StopToken() = default;
+		explicit StopToken(const std::atomic<bool>& stop) : mStop(&stop) {}
+
+		/**
+		* @return true if the owning StopSource requested a stop
+		**/
+		bool stop_requested() const { return mStop != nullptr && mStop->load(std::memory_order_relaxed); }
+	};
+
+
+	/**
+	* @brief owner of a stop request (std::stop_source-style). The parallel sort templates check its tokens at partition boundaries
+	* and let all worker tasks return early. The range is left in an unspecified order, but all elements are kept
+	**/
+	class StopSource
+	{
+		std::atomic<bool> mStop{ false };
+
+	public:
+		void request_stop() { mStop.store(true, std::memory_order_relaxed); }
+		void reset() { mStop.store(false, std::memory_order_relaxed); }
+		bool stop_requested() const { return mStop.load(std::memory_order_relaxed); }
+		StopToken token() const { return StopToken(mStop); }
+	};
+
+
+	/**
+	* @brief scratch memory which is reused across sorts. The executor owns one arena and reserves it before timing an algorithm
+	* which uses it, so the sort templates neither allocate nor page fault fresh buffers; algorithms without a buffer never touch
+	* it and the arena stays empty. The memory is uninitialized storage, the algorithms construct
+	* and destroy their elements in it. Not thread safe: an algorithm acquires it once and splits it between its worker tasks
+	**/
+	class ScratchArena
+	{
+		std::unique_ptr<std::max_align_t[]> mMemory;
+		size_t mCapacity{ 0 };	//bytes
+
+	public:
+		/**
+		* @brief grows the arena to at least bytes. New memory is zeroed, so its pages are faulted in here instead of inside a sort
+		* @return void
+		**/
+		void reserve(const size_t bytes)
+		{
+			if (bytes <= mCapacity)
+				return;
+			const auto blocks = (bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+			mMemory.reset();
+			mMemory.reset(new std::max_align_t[blocks]());
+			mCapacity = blocks * sizeof(std::max_align_t);
+		}
+
+		/**
+		* @brief storage for count elements of T, valid until the next acquire or reserve
+		* @return pointer to uninitialized storage
+		**/
+		template <typename T>
+		T* acquire(const size_t count)
+		{
+			static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+			reserve(count * sizeof(T));
+			return reinterpret_cast<T*>(mMemory.get());
+		}
+
+		size_t capacity() const { return mCapacity; }
 	};
 
 
@@ -62,7 +157,7 @@ namespace sort
 
 
 	/**
-	* @brief check container is sorted recursively
+	* @brief check container is sorted recursively. Both halves are checked recursively, so the recursion depth is log2(n)
 	* @param begin: iterator to the begin of the container
 	* @param end: iterator to the end of the container
 	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
@@ -71,12 +166,11 @@ namespace sort
 	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
 	bool verifiy_sort_order_rc(I begin, I end, U cmp = U())
 	{
-		I last = begin;
-		if (begin == end || ++begin == end) //tail call
+		const auto dist = std::distance(begin, end);
+		if (dist < 2)
 			return true;
-		if (cmp(*last, *begin))
-			return verifiy_sort_order_rc(begin, end, cmp);
-		return false;
+		const I mid = std::next(begin, dist / 2);
+		return !cmp(*mid, *std::prev(mid)) && verifiy_sort_order_rc(begin, mid, cmp) && verifiy_sort_order_rc(mid, end, cmp);
 	}
 
 
@@ -104,10 +198,10 @@ namespace sort
 	* @return true if value was found, else false
 	**/
 	template <typename I, typename V = typename std::iterator_traits<I>::value_type , typename U = std::less<typename std::iterator_traits<I>::value_type> >
-	bool binary_search(I begin, I end, V &value, U cmp = U())
+	bool binary_search(I begin, I end, const V &value, U cmp = U())
 	{
 		begin = std::lower_bound(begin, end, value, cmp);
-		return (begin != end && *begin == value);
+		return (begin != end && !cmp(value, *begin));	//equivalent by cmp, no operator== needed
 	}
 
 
@@ -137,34 +231,35 @@ namespace sort
 	}
 
 
+	/**
+	* @brief one recursive bubblesort run, moves the largest element to the end. The run over the left half (including the first element of the right half)
+	* ends with its largest element at the border, the run over the right half continues with it. Same swaps as the iterative run, recursion depth log2(n)
+	* @return true if no elements were swapped
+	**/
 	template <typename I, typename U>
-	bool _bubblesort_rc(const I firstBegin, const I begin, I end, U cmp)
+	bool _bubblesort_rc(const I begin, const I end, U cmp)
 	{
 		using std::swap;
-		if (begin == end)
-			return true;
-
-		const I next = std::next(begin);
 
-		if (next == end) //tail call
+		const auto dist = std::distance(begin, end);
+		if (dist < 2)
 			return true;
-
-		auto sorted = true;
-		if (cmp(*next, *begin)) //sort 2 elements
+		if (dist == 2) //sort 2 elements
 		{
+			const I next = std::next(begin);
+			if (!cmp(*next, *begin))
+				return true;
 			swap(*begin, *next);
-			sorted = false;
+			return false;
 		}
-		sorted &= _bubblesort_rc(firstBegin, std::next(begin), end, cmp);
-		//1 rc bubblesort run to the last element, will return false if 1 element is not sorted
-		if (begin == firstBegin && !sorted)
-			//if first call and array is not sorted, repeat process, but ignore last element
-			_bubblesort_rc(firstBegin, firstBegin, --end, cmp);
-		return sorted;
+
+		const I mid = std::next(begin, dist / 2);
+		const auto sorted = _bubblesort_rc(begin, std::next(mid), cmp);
+		return _bubblesort_rc(mid, end, cmp) && sorted;
 	}
 
 	/**
-	* @brief recursive bubblesort template
+	* @brief recursive bubblesort template. Runs are repeated without the last element until a run swaps nothing (tail call written as loop)
 	* @param begin: iterator to the begin of the container
 	* @param end: iterator to the end of the container
 	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
@@ -173,7 +268,8 @@ namespace sort
 	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
 	void bubblesort_rc(I begin, I end, U cmp = U())
 	{
-		_bubblesort_rc(begin, begin, end, cmp);
+		while (begin != end && !_bubblesort_rc(begin, end, cmp))
+			--end;
 	}
 
 
@@ -267,7 +363,7 @@ namespace sort
 
 		for (I next = std::next(begin), prev; next != end; ++next)
 		{
-			auto value = *next;
+			typename std::iterator_traits<I>::value_type value = std::move(*next);
 			auto itToBegin = false;
 
 			for (prev = std::prev(next); cmp(value, *prev); --prev)
@@ -281,7 +377,26 @@ namespace sort
 			}
 			if (!itToBegin)
 				++prev;
-			*prev = value;
+			*prev = std::move(value);
+		}
+	}
+
+
+	/**
+	* @brief binary insertionsort. Inserts all elements of [sortedEnd, end) into the already sorted range [begin, sortedEnd) (stable)
+	**/
+	template <typename I, typename U>
+	void _binary_insertionsort(I begin, I sortedEnd, I end, U cmp)
+	{
+		//binary search for the position, then shift the block behind it by one (instead of std::rotate per element)
+		for (; sortedEnd != end; ++sortedEnd)
+		{
+			if (!cmp(*sortedEnd, *std::prev(sortedEnd))) //already in place
+				continue;
+			typename std::iterator_traits<I>::value_type value = std::move(*sortedEnd);
+			I pos = std::upper_bound(begin, sortedEnd, value, cmp);
+			std::move_backward(pos, sortedEnd, std::next(sortedEnd));
+			*pos = std::move(value);
 		}
 	}
 
@@ -296,10 +411,103 @@ namespace sort
 	template <typename I, typename U = std::less<typename std::remove_reference<decltype(*std::declval<I>())>::type> >	//this works for stl but not std::less<decltype(*std::declval<I>())> >  -_-
 	void insertionsort_binsearch(I begin, I end, U cmp = U())
 	{
-		//shorter and much nicer version of insertionsort but this is not my work (cppreference) :(
-		//uses binary search
+		if (begin == end)
+			return;
+		_binary_insertionsort(begin, std::next(begin), end, cmp);
+	}
+
+
+	/**
+	* @brief true if I is a pointer or a std::vector iterator (elements are stored contiguously)
+	**/
+	template <typename I, typename V = typename std::iterator_traits<I>::value_type>
+	struct _is_contiguous_iterator : std::integral_constant<bool, std::is_pointer<I>::value ||
+		(!std::is_same<V, bool>::value && (std::is_same<I, typename std::vector<V>::iterator>::value || std::is_same<I, typename std::vector<V>::const_iterator>::value))> {};
+
+
+	/**
+	* @brief true if insertionsort_leaf can use memmove for shifting blocks of elements
+	**/
+	template <typename I>
+	struct _use_block_moves : std::integral_constant<bool, _is_contiguous_iterator<I>::value &&
+		std::is_trivially_copyable<typename std::iterator_traits<I>::value_type>::value> {};
+
+
+	/**
+	* @brief inserts *last into the sorted range before it. There must be an element not greater than *last in front of it (sentinel)
+	**/
+	template <typename I, typename U>
+	void _unguarded_linear_insert(I last, U cmp)
+	{
+		typename std::iterator_traits<I>::value_type value = std::move(*last);
+		for (I prev = std::prev(last); cmp(value, *prev); --prev)
+		{
+			*last = std::move(*prev);
+			last = prev;
+		}
+		*last = std::move(value);
+	}
+
+
+	template <typename I, typename U>
+	void _insertionsort_leaf(I begin, I end, U cmp, std::false_type)
+	{
+		if (begin == end)
+			return;
+
 		for (I next = std::next(begin); next != end; ++next)
-			std::rotate(std::upper_bound(begin, next, *next,cmp), next, std::next(next));
+		{
+			if (cmp(*next, *begin))
+			{
+				//new minimum, shift the whole sorted part. *begin is the sentinel for all following inserts
+				typename std::iterator_traits<I>::value_type value = std::move(*next);
+				std::move_backward(begin, next, std::next(next));
+				*begin = std::move(value);
+			}
+			else
+			{
+				_unguarded_linear_insert(next, cmp);
+			}
+		}
+	}
+
+
+	template <typename I, typename U>
+	void _insertionsort_leaf(I begin, I end, U cmp, std::true_type)
+	{
+		using V = typename std::iterator_traits<I>::value_type;
+
+		if (begin == end)
+			return;
+
+		V* const first = std::addressof(*begin);
+		const auto size = std::distance(begin, end);
+		for (std::ptrdiff_t i = 1; i < size; ++i)
+		{
+			V value = first[i];
+			if (!cmp(value, first[i - 1])) //already in place
+				continue;
+			//binary search for the position, then shift the block with one memmove
+			V* const pos = std::upper_bound(first, first + i - 1, value, cmp);
+			std::memmove(pos + 1, pos, static_cast<size_t>(first + i - pos) * sizeof(V));
+			*pos = value;
+		}
+	}
+
+
+	/**
+	* @brief insertionsort template for small ranges, used as base case of the recursive sorts. Moves instead of copying and 
+	* uses the first element as sentinel for an unguarded inner loop. Trivially copyable elements in contiguous memory
+	* are inserted with binary search and memmove.
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+	* @return void
+	**/
+	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
+	void insertionsort_leaf(I begin, I end, U cmp = U())
+	{
+		_insertionsort_leaf(begin, end, cmp, _use_block_moves<I>());
 	}
 
 
@@ -323,7 +531,7 @@ namespace sort
 			//insertionsort with gap as distance instead of 1
 			for (auto gap = gaps[g], j = gap; j < size; j += gap)
 			{
-				auto next_Element = std::move(*std::next(begin, j));
+				typename std::iterator_traits<I>::value_type next_Element = std::move(*std::next(begin, j));
 				auto i = j - gap;
 
 				while (i >= 0 && cmp(next_Element, *std::next(begin, i)))
@@ -441,7 +649,7 @@ namespace sort
 		for (I start = begin; start != end; ++start)
 		{
 			I old_pos = start;
-			auto current_element = *start;
+			typename std::iterator_traits<I>::value_type current_element = *start;
 			while (start != new_pos) //complete a full cycle
 			{
 				new_pos = start;
@@ -453,9 +661,15 @@ namespace sort
 				if (new_pos == old_pos) //check if element is already in correct position
 					break;
 
-				while (!cmp(*new_pos, current_element) && !cmp(current_element, *new_pos)) //position right after duplicates
+				while (new_pos != end && !cmp(*new_pos, current_element) && !cmp(current_element, *new_pos)) //position right after duplicates
 					++new_pos;
 
+				if (new_pos == end) //inconsistent comparisons (e.g. a cancelled sort). put the element back and close the cycle
+				{
+					*start = std::move(current_element);
+					break;
+				}
+
 				old_pos = new_pos;
 				swap(*new_pos, current_element); //swap to correct position, use now old element in array for comparison
 			}
@@ -566,38 +780,137 @@ namespace sort
 
 
 	/**
-	* @brief radixsort template
+	* @brief radix key of an element. Unsigned integer of the same width with the same order as the element: signed integers flip the sign bit,
+	* floating point numbers flip the sign bit of positive and all bits of negative values. Other types (SortingData) are read as int with the bitwise '&' operator
+	* @param x: element
+	* @return unsigned radix key
+	**/
+	template <typename T>
+	auto radix_key(const T& x)
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			using K = std::conditional_t<sizeof(T) == sizeof(std::uint64_t), std::uint64_t, std::uint32_t>;
+			static_assert(sizeof(T) == sizeof(K), "unsupported floating point type");
+			K bits;
+			std::memcpy(&bits, &x, sizeof(K));
+			const auto sign = K(1) << (sizeof(K) * 8 - 1);
+			return static_cast<K>((bits & sign) ? ~bits : bits | sign);
+		}
+		else if constexpr (std::is_integral_v<T>)
+		{
+			using K = std::make_unsigned_t<T>;
+			if constexpr (std::is_signed_v<T>)
+				return static_cast<K>(static_cast<K>(x) ^ (K(1) << (sizeof(K) * 8 - 1)));
+			else
+				return static_cast<K>(x);
+		}
+		else
+		{
+			return radix_key(static_cast<int>(x & -1));
+		}
+	}
+
+	/**
+	* @brief min. and max. radix key (prepass of the radix and counting sorts)
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param maxThreads: (optional) max. number of threads which search min. and max. parallel. default: 0
+	* @return min. and max. radix key. [begin, end) must not be empty
+	**/
+	template <typename I>
+	auto radix_minmax(I begin, I end, const int maxThreads = 0)
+	{
+		using K = decltype(radix_key(*begin));
+		const auto minmax = [](I first, I last)
+		{
+			auto range = std::make_pair(std::numeric_limits<K>::max(), std::numeric_limits<K>::min());
+			for (; first != last; ++first)
+			{
+				const auto key = radix_key(*first);
+				range.first = std::min(range.first, key);
+				range.second = std::max(range.second, key);
+			}
+			return range;
+		};
+
+		const auto size = std::distance(begin, end);
+		if (maxThreads <= 1 || size < 2 * leafSortThreshold * maxThreads)
+			return minmax(begin, end);
+
+		std::vector<std::future<std::pair<K, K>>> parts;
+		for (auto t = 1; t < maxThreads; ++t)
+			parts.push_back(std::async(std::launch::async, minmax, std::next(begin, size * t / maxThreads), std::next(begin, size * (t + 1) / maxThreads)));
+		auto range = minmax(begin, std::next(begin, size / maxThreads));
+		for (auto& part : parts)
+		{
+			const auto partRange = part.get();
+			range.first = std::min(range.first, partRange.first);
+			range.second = std::max(range.second, partRange.second);
+		}
+		return range;
+	}
+
+	/**
+	* @brief significant range of the radix keys (prepass of the radix sorts). Keys are sorted by their distance to the min. key,
+	* so only the bits which differ between min. and max. key need a pass
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param maxThreads: (optional) max. number of threads which search min. and max. parallel. default: 0
+	* @return min. key and number of significant bits of max. key - min. key (0 if all keys are equal)
+	**/
+	template <typename I>
+	auto radix_range(I begin, I end, const int maxThreads = 0)
+	{
+		using K = decltype(radix_key(*begin));
+		if (std::distance(begin, end) < 2)
+			return std::make_pair(K(0), 0);
+
+		const auto range = radix_minmax(begin, end, maxThreads);
+		auto bits = 0;
+		for (auto difference = static_cast<K>(range.second - range.first); difference != 0; difference >>= 1)
+			++bits;
+		return std::make_pair(range.first, bits);
+	}
+
+	/**
+	* @brief radixsort template (LSD, one bit per pass). Only the significant bits of the keys are sorted (see radix_range).
+	* Each pass splits the elements stably into one scratch buffer: 0 bits from the front, 1 bits reversed from the back
 	* @param begin: iterator to the begin of the container
 	* @param end: iterator to the end of the container
-	* @param bits: (optional) number of bits used for sorting. default: 32
+	* @param scratch: (optional) arena for the buffer, a temporary one is used if nullptr
 	* @return void
-	* @note bitwise '&' operator needs to be defined
+	* @note radix_key has to support the value type (integers, floating point numbers or bitwise '&' operator)
 	**/
 	template <typename I>
-	void radixsort(I begin, I end,const int bits = 32)
+	void radixsort(I begin, I end, ScratchArena* scratch = nullptr)
 	{
-		std::vector<typename std::iterator_traits<I>::value_type> buckets[2];
+		using V = typename std::iterator_traits<I>::value_type;
+		const auto range = radix_range(begin, end);
+		if (range.second == 0)
+			return;
+
 		const size_t size = std::distance(begin, end);
-		buckets[0].resize(size);
-		buckets[1].resize(size);
-		int top[2] = {0, 0}; //index of next top element in bucket0 and bucket1
+		ScratchArena temporary;
+		V* buffer = (scratch ? *scratch : temporary).template acquire<V>(size);
 
-		for (auto b = 0; b < bits; ++b)
+		for (auto b = 0; b < range.second; ++b)
 		{
+			size_t zeros = 0, ones = size; //buffer[0, zeros): bit is 0, buffer[ones, size): bit is 1 in reverse order
 			for (auto i = begin; i != end; ++i) //sort into buckets
 			{
-				if (*i & (1 << b))
-					buckets[1][top[1]++] = std::move(*i); //next MSB is 1
+				if (((radix_key(*i) - range.first) >> b) & 1)
+					::new (static_cast<void*>(buffer + --ones)) V(std::move(*i)); //next MSB is 1
 				else
-					buckets[0][top[0]++] = std::move(*i); //next MSB is 0
+					::new (static_cast<void*>(buffer + zeros++)) V(std::move(*i)); //next MSB is 0
 			}
 
 			auto j = begin;
-			for (auto x = 0; x < top[0]; ++x, ++j)
-				*j = std::move(buckets[0][x]);
-			for (auto x = 0; x < top[1]; ++x, ++j)
-				*j = std::move(buckets[1][x]);
-			top[0] = top[1] = 0;
+			for (size_t x = 0; x < zeros; ++x, ++j)
+				*j = std::move(buffer[x]);
+			for (size_t x = size; x-- > ones; ++j)
+				*j = std::move(buffer[x]);
+			std::destroy(buffer, buffer + size);
 		}
 	}
 
@@ -606,63 +919,61 @@ namespace sort
 	* visualizes the sorting process better and illustrates the performance difference between copy & move
 	* @param begin: iterator to the begin of the container
 	* @param end: iterator to the end of the container
-	* @param bits: (optional) number of bits used for sorting. default: 32
+	* @param scratch: (optional) arena for the buffer, a temporary one is used if nullptr
 	* @return void
-	* @note bitwise '&' operator needs to be defined
+	* @note radix_key has to support the value type (integers, floating point numbers or bitwise '&' operator)
 	**/
 	template <typename I>
-	void radixsort_slow(I begin, I end,const int bits = 32)
+	void radixsort_slow(I begin, I end, ScratchArena* scratch = nullptr)
 	{
-		std::vector<typename std::iterator_traits<I>::value_type> buckets[2];
+		using V = typename std::iterator_traits<I>::value_type;
+		const auto range = radix_range(begin, end);
+		if (range.second == 0)
+			return;
+
 		const size_t size = std::distance(begin, end);
-		buckets[0].resize(size);
-		buckets[1].resize(size);
-		int top[2] = { 0, 0 }; //index of next top element in bucket0 and bucket1
+		ScratchArena temporary;
+		V* buffer = (scratch ? *scratch : temporary).template acquire<V>(size);
 
-		for (auto b = 0; b < bits; ++b)
+		for (auto b = 0; b < range.second; ++b)
 		{
+			size_t zeros = 0, ones = size; //buffer[0, zeros): bit is 0, buffer[ones, size): bit is 1 in reverse order
 			for (auto i = begin; i != end; ++i) //sort into buckets
 			{
-				if (*i & (1 << b))
-					buckets[1][top[1]++] = *i; //next MSB is 1
+				if (((radix_key(*i) - range.first) >> b) & 1)
+					::new (static_cast<void*>(buffer + --ones)) V(*i); //next MSB is 1
 				else
-					buckets[0][top[0]++] = *i; //next MSB is 0
+					::new (static_cast<void*>(buffer + zeros++)) V(*i); //next MSB is 0
 			}
 
 			auto j = begin;
-			for (auto x = 0; x < top[0]; ++x, ++j)
-				*j = buckets[0][x];
-			for (auto x = 0; x < top[1]; ++x, ++j)
-				*j = buckets[1][x];
-			top[0] = top[1] = 0;
+			for (size_t x = 0; x < zeros; ++x, ++j)
+				*j = buffer[x];
+			for (size_t x = size; x-- > ones; ++j)
+				*j = buffer[x];
+			std::destroy(buffer, buffer + size);
 		}
 	}
 
 
 	/**
-	* @brief radixsort template
-	* @param begin: iterator to the begin of the container
-	* @param end: iterator to the end of the container
-	* @param bits: (optional) number of bits used for sorting. default: 32
-	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
-	* @param maxThreads: (optional) max. number of threads which can run this algorithm parallel. default: 0
-	* @return void
-	* @note bitwise '&' operator needs to be defined
+	* @brief sorts [begin, end) by bit 'bit' and below of the biased radix keys (MSD). used by radixsort_ip_is
 	**/
-	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
-	void radixsort_ip_is(I begin, I end,int bits = 32, U cmp = U(), int maxThreads = 0)
+	template <typename I, typename K, typename U>
+	void _radixsort_ip_is(I begin, I end, int bit, const K minKey, U cmp, const int maxThreads, const StopToken stop)
 	{
 		using std::swap;
 
-		if (std::distance(begin, end) <= 1)
+		if (bit == 0 || std::distance(begin, end) <= 1 || stop.stop_requested())
 			return;
-		--bits;
+		--bit;
+		const auto digit = [bit, minKey](const auto& x) { return ((radix_key(x) - minKey) >> bit) & 1; };
 		auto lb = begin; //left index
 		auto rb = std::prev(end); //right index
 
 		while (lb != rb)
 		{
-			if (*lb & (1 << bits)) //move all 1's to the right and 0's to the left
+			if (digit(*lb)) //move all 1's to the right and 0's to the left
 			{
 				swap(*lb, *rb);
 				--rb; //rb moves to next element, because digit of current element is definitly '1' 
@@ -673,35 +984,35 @@ namespace sort
 			}
 		}
 
-		if (*lb & (1 << bits) && lb != begin) //lb needs to be placed on the last 0, for splitting the array
-			--lb;
+		//first element with a leading 1 (lb itself was not checked by the loop above)
+		const I mid = digit(*lb) ? lb : std::next(lb);
 
-		if (bits != 0)
+		if (bit != 0)
 		{
-			if (std::distance(begin, end) < 20) //switch to insertionsort if size gets smaller than 20
+			if (std::distance(begin, end) < leafSortThreshold) //switch to insertionsort if size gets smaller than leafSortThreshold
 			{
-				insertionsort(begin, std::next(lb),cmp);
-				insertionsort(std::next(lb), end,cmp);
+				insertionsort_leaf(begin, mid, cmp);
+				insertionsort_leaf(mid, end, cmp);
 			}
 			else
 			{
 				std::future<void> f1, f2;
 				//rec. call on array with leading 0's of current call
-				if (lb != begin)
+				if (std::distance(begin, mid) > 1)
 				{
-					if (maxThreads > 0)
-						f1 = std::async([&]() { radixsort_ip_is(begin, std::next(lb), bits, cmp,--maxThreads); });
+					if (maxThreads > 1)
+						f1 = std::async([&]() { _radixsort_ip_is(begin, mid, bit, minKey, cmp, maxThreads - 2, stop); });
 					else
-						radixsort_ip_is(begin, std::next(lb), bits, cmp, 0);
+						_radixsort_ip_is(begin, mid, bit, minKey, cmp, 0, stop);
 				}
 
 				//rec. call array with leading 1's
-				if (rb != std::prev(end))
+				if (std::distance(mid, end) > 1)
 				{
-					if (maxThreads > 0)
-						f2 = std::async([&]() { radixsort_ip_is(std::next(lb), end, bits, cmp, --maxThreads); });
+					if (maxThreads > 1)
+						f2 = std::async([&]() { _radixsort_ip_is(mid, end, bit, minKey, cmp, maxThreads - 2, stop); });
 					else
-						radixsort_ip_is(std::next(lb), end, bits, cmp, 0);
+						_radixsort_ip_is(mid, end, bit, minKey, cmp, 0, stop);
 				}
 
 				//wait for finish if started
@@ -713,6 +1024,25 @@ namespace sort
 		}
 	}
 
+	/**
+	* @brief radixsort template (MSD, in-place, one bit per level). Only the significant bits of the keys are sorted (see radix_range), small ranges are sorted with insertionsort
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b. has to be consistent with the order of radix_key
+	* @param maxThreads: (optional) max. number of threads which can run this algorithm parallel. default: 0
+	* @param stop: (optional) token which stops the sort early
+	* @return void
+	* @note radix_key has to support the value type (integers, floating point numbers or bitwise '&' operator)
+	**/
+	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
+	void radixsort_ip_is(I begin, I end, U cmp = U(), const int maxThreads = 0, const StopToken stop = StopToken())
+	{
+		if (std::distance(begin, end) <= 1 || stop.stop_requested())
+			return;
+		const auto range = radix_range(begin, end, maxThreads);
+		_radixsort_ip_is(begin, end, range.second, range.first, cmp, maxThreads, stop);
+	}
+
 
 	/**
 	* @brief partition template. Moves all elements smaller than the pivot to the left and everything else to the right
@@ -741,57 +1071,174 @@ namespace sort
 	}
 
 
+	/**
+	* @brief three-way partition template (Dutch national flag). Moves all elements smaller than the pivot to the left, all elements equal to the pivot
+	* to the middle and everything else to the right
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param pivot: value of the pivot (not an element of the range, the range is permuted)
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+	* @return iterators to the first element equal to the pivot and to the first greater element
+	**/
+	template <typename I, typename V, typename U>
+	std::pair<I, I> partition3(I begin, I end, const V& pivot, U cmp)
+	{
+		using std::swap;
+
+		I lt = begin; //first element which is not < pivot
+		I gt = end; //first element which is > pivot
+		while (begin != gt)
+		{
+			if (cmp(*begin, pivot))
+			{
+				swap(*lt, *begin);
+				++lt;
+				++begin;
+			}
+			else if (cmp(pivot, *begin))
+			{
+				--gt;
+				swap(*begin, *gt);
+			}
+			else
+			{
+				++begin;
+			}
+		}
+		return { lt, gt };
+	}
+
+
 	/**
 	* @brief median of three template. returns the b for a < b < c
 	* @param first: iterator to the first element
 	* @param second: iterator to the second element
 	* @param third: iterator to the third element
-	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b. compares the elements, not the iterators
 	* @return iterator reference tob for a < b < c
 	**/
 	template <typename I, typename U = std::less <typename std::iterator_traits<I>::value_type> >
 	I median_of_three(const I &first,const I &second,const I &third, U cmp = U())
 	{
-		return std::max(std::min(first, second,cmp), std::min(std::max(first, second, cmp), third, cmp), cmp);
+		if (cmp(*first, *second))
+		{
+			if (cmp(*second, *third))
+				return second;
+			return cmp(*first, *third) ? third : first;
+		}
+		if (cmp(*first, *third))
+			return first;
+		return cmp(*second, *third) ? third : second;
 	}
 
 
 	/**
-	* @brief quicksort template (with optional multithreading)
+	* @brief pivot selection and partition step of quicksort and introsort. The pivot is the median of three. If another candidate equals the median,
+	* the range probably contains many duplicates and a three-way partition takes all elements equal to the pivot out of the recursion.
+	* The comparisons of the median selection show which candidate may equal the median, so one more comparison detects it. Only if
+	* third <= second <= first both neighbours may equal the median, this case costs two more (5 comparisons in total)
 	* @param begin: iterator to the begin of the container
-	* @param end: iterator to the end of the container
-	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
-	* @param maxThreads: number of max concurrent threads. default = 0 (no multithreading)
-	* @return void
+	* @param end: iterator to the end of the container (at least 3 elements)
+	* @param cmp: compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+	* @return elements equal to the pivot in their final position [first, second). recurse on [begin, first) and [second, end)
 	**/
-	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
-	void quicksort(I begin, I end, U cmp = U(), const int maxThreads = 0)
+	template <typename I, typename U>
+	std::pair<I, I> _quicksort_partition(I begin, I end, U cmp)
 	{
 		using std::swap;
 
-		const auto dist = std::distance(begin, end);
-		if (dist < 2) //tail call
-			return;
+		const I first = begin, second = std::next(begin, std::distance(begin, end) / 2), third = std::prev(end);
+		//same decisions as median_of_three. low <= high is known, so they are equal if !cmp(low, high)
+		I median = second;
+		auto duplicates = false;
+		if (cmp(*first, *second))
+		{
+			if (!cmp(*second, *third))
+			{
+				if (cmp(*first, *third))	//first < third <= second
+				{
+					median = third;
+					duplicates = !cmp(*third, *second);
+				}
+				else	//third <= first < second
+				{
+					median = first;
+					duplicates = !cmp(*third, *first);
+				}
+			}
+		}
+		else if (cmp(*first, *third))	//second <= first < third
+		{
+			median = first;
+			duplicates = !cmp(*second, *first);
+		}
+		else if (cmp(*second, *third))	//second < third <= first
+		{
+			median = third;
+			duplicates = !cmp(*third, *first);
+		}
+		else	//third <= second <= first
+		{
+			duplicates = !cmp(*second, *first) || !cmp(*third, *second);
+		}
 
-		//median of three
-		I pivot = std::prev(end);
-		swap(*median_of_three(begin, std::next(begin, dist / 2), std::prev(end), cmp), *pivot);
+		if (duplicates)
+		{
+			const typename std::iterator_traits<I>::value_type pivot = *median;
+			return partition3(begin, end, pivot, cmp);
+		}
 
-		//partition
+		I pivot = std::prev(end);
+		swap(*median, *pivot);
 		I pivPos = sort::partition(begin, pivot, cmp);
 		//move pivot to correct position
 		swap(*pivPos, *pivot);
-		if (maxThreads > 1)
-		{
-			std::future<void> f1 = std::async([&]() {quicksort(begin, pivPos, cmp, maxThreads - 2); });
-			std::future<void> f2 = std::async([&]() {quicksort(std::next(pivPos), end, cmp, maxThreads - 2); });
-			f1.get();
-			f2.get();
-		}
-		else
+		return { pivPos, std::next(pivPos) };
+	}
+
+
+	/**
+	* @brief quicksort template (with optional multithreading)
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+	* @param maxThreads: number of max concurrent threads. default = 0 (no multithreading)
+	* @param stop: (optional) token which stops the sort early
+	* @return void
+	**/
+	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
+	void quicksort(I begin, I end, U cmp = U(), const int maxThreads = 0, const StopToken stop = StopToken())
+	{
+		//the smaller part is sorted recursively and the larger one by the loop, so the stack depth is at most log2(n)
+		while (!stop.stop_requested())
 		{
-			quicksort(begin, pivPos, cmp,0);
-			quicksort(std::next(pivPos), end, cmp,0);
+			const auto dist = std::distance(begin, end);
+			if (dist < leafSortThreshold)
+			{
+				insertionsort_leaf(begin, end, cmp);
+				return;
+			}
+
+			//median of three & partition. elements equal to the pivot are not sorted again
+			const auto pivots = _quicksort_partition(begin, end, cmp);
+			if (maxThreads > 1)
+			{
+				std::future<void> f1 = std::async([&]() {quicksort(begin, pivots.first, cmp, maxThreads - 2, stop); });
+				std::future<void> f2 = std::async([&]() {quicksort(pivots.second, end, cmp, maxThreads - 2, stop); });
+				f1.get();
+				f2.get();
+				return;
+			}
+			if (std::distance(begin, pivots.first) < std::distance(pivots.second, end))
+			{
+				quicksort(begin, pivots.first, cmp, 0, stop);
+				begin = pivots.second;
+			}
+			else
+			{
+				quicksort(pivots.second, end, cmp, 0, stop);
+				end = pivots.first;
+			}
 		}
 	}
 
@@ -830,7 +1277,7 @@ namespace sort
 		{
 			if (cmp(*rightList,*leftList))
 			{
-				auto tmp = std::move(*leftList);
+				typename std::iterator_traits<I>::value_type tmp = std::move(*leftList);
 				*leftList = std::move(*rightList);
 				//move all elements to the left, until correct position is found
 				auto i = std::next(rightList);
@@ -849,94 +1296,876 @@ namespace sort
 	}
 
 	/**
-	* @brief mergesort template (optional multithreading)
-	* @param begin: iterator to the begin of the container
-	* @param end: iterator to the end of the container
-	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
-	* @param maxThreads: number of max concurrent threads. default = 0 (no multithreading)
-	* @return void
+	* @brief merges the sorted ranges [begin, mid) and [mid, end) stable. The left range is moved into buffer (uninitialized storage)
+	* and merged back with the right range
 	**/
-	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >	//this works but not std::less<decltype(*std::declval<I>())> >  -_-
-	void mergesort(I begin, I end, U cmp = U(), int maxThreads = 0)
+	template <typename I, typename V, typename U>
+	void _merge_buffered(I begin, I mid, I end, U cmp, V* buffer)
+	{
+		V* left = buffer;
+		V* const leftEnd = buffer + std::distance(begin, mid);
+		for (auto i = begin; i != mid; ++i)
+			::new (static_cast<void*>(left++)) V(std::move(*i));
+
+		left = buffer;
+		for (; left != leftEnd && mid != end; ++begin)
+		{
+			if (cmp(*mid, *left))
+				*begin = std::move(*mid++);
+			else
+				*begin = std::move(*left++);
+		}
+		for (; left != leftEnd; ++left, ++begin)
+			*begin = std::move(*left);
+		std::destroy(buffer, leftEnd);
+	}
+
+	/**
+	* @brief mergesort of [begin, end) with buffer as scratch storage for its elements. The halves use disjoint parts of the buffer,
+	* so the parallel tasks share it
+	**/
+	template <typename I, typename V, typename U>
+	void _mergesort(I begin, I end, U cmp, const int maxThreads, const StopToken stop, V* buffer)
 	{
+		if (stop.stop_requested())
+			return;
 		const auto dist = std::distance(begin, end);
-		//tail call
-		if (dist < 2)
+		if (dist < leafSortThreshold)
+		{
+			insertionsort_leaf(begin, end, cmp);
 			return;
+		}
 		//split
 		I mid = std::next(begin, dist / 2);
 		if (maxThreads > 1)
 		{
-			std::future<void> f1 = std::async([&]() {mergesort(begin, mid,cmp, maxThreads - 2); });
-			std::future<void> f2 = std::async([&]() {mergesort(mid, end, cmp, maxThreads - 2); });
+			std::future<void> f1 = std::async([&]() {_mergesort(begin, mid, cmp, maxThreads - 2, stop, buffer); });
+			std::future<void> f2 = std::async([&]() {_mergesort(mid, end, cmp, maxThreads - 2, stop, buffer + dist / 2); });
 			f1.get();
 			f2.get();
 		}
 		else
 		{
-			mergesort(begin, mid, cmp,0);
-			mergesort(mid, end, cmp,0);
+			_mergesort(begin, mid, cmp, 0, stop, buffer);
+			_mergesort(mid, end, cmp, 0, stop, buffer + dist / 2);
 		}
+		if (stop.stop_requested())
+			return;
 		//merge
-		std::inplace_merge(begin, mid,end,cmp);
+		_merge_buffered(begin, mid, end, cmp, buffer);
 		//inplace_merge(begin,mid,end,cmp);	//slow, because of the shifts required
 	}
 
+	/**
+	* @brief mergesort template (optional multithreading)
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+	* @param maxThreads: number of max concurrent threads. default = 0 (no multithreading)
+	* @param stop: (optional) token which stops the sort early
+	* @param scratch: (optional) arena for the merge buffer, a temporary one is used if nullptr
+	* @return void
+	**/
+	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >	//this works but not std::less<decltype(*std::declval<I>())> >  -_-
+	void mergesort(I begin, I end, U cmp = U(), int maxThreads = 0, const StopToken stop = StopToken(), ScratchArena* scratch = nullptr)
+	{
+		using V = typename std::iterator_traits<I>::value_type;
+		ScratchArena temporary;
+		V* buffer = (scratch ? *scratch : temporary).template acquire<V>(std::distance(begin, end));
+		_mergesort(begin, end, cmp, maxThreads, stop, buffer);
+	}
+
 
 
 	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type>>
-	void _introsort(I begin, I end, U cmp = U(),const int maxDepth = 8,const int maxThreads = 0)
+	void _introsort(I begin, I end, U cmp = U(),const int maxDepth = 8,const int maxThreads = 0, const StopToken stop = StopToken())
 	{
-		using std::swap;
+		//the smaller part is sorted recursively and the larger one by the loop, every iteration is one level of depth
+		for (auto depth = maxDepth; !stop.stop_requested(); --depth)
+		{
+			const auto dist = std::distance(begin, end);
+			if (dist < leafSortThreshold)
+			{
+				insertionsort_leaf(begin, end, cmp);
+				return;
+			}
+
+			if (depth == 0)
+			{
+				heapsort(begin, end, cmp);
+				return;
+			}
+
+			//median of three & partition. elements equal to the pivot are not sorted again
+			const auto pivots = _quicksort_partition(begin, end, cmp);
+			
+			if (maxThreads > 1)
+			{
+				std::future<void> f1 = std::async([&]() {_introsort(begin, pivots.first, cmp, depth - 1,maxThreads - 2, stop); });
+				std::future<void> f2 = std::async([&]() {_introsort(pivots.second, end, cmp, depth - 1,maxThreads - 2, stop); });
+				f1.get();
+				f2.get();
+				return;
+			}
+			if (std::distance(begin, pivots.first) < std::distance(pivots.second, end))
+			{
+				_introsort(begin, pivots.first, cmp, depth - 1, 0, stop);
+				begin = pivots.second;
+			}
+			else
+			{
+				_introsort(pivots.second, end, cmp, depth - 1, 0, stop);
+				end = pivots.first;
+			}
+		}
+	}
 
+	/**
+	* @brief introsort template
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+	* @param maxThreads: (optional) max. number of threads which can run this algorithm parallel. default: 0
+	* @param stop: (optional) token which stops the sort early
+	* @return void
+	**/
+	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
+	void introsort(I begin, I end, U cmp = U(),int maxThreads = 0, const StopToken stop = StopToken())
+	{
 		const auto dist = std::distance(begin, end);
-		if (dist < 2) //tail call
+		if (dist < 2)
 			return;
+		const auto maxDepth = static_cast<int>(std::log2(static_cast<double>(dist)));
+		_introsort(begin, end, cmp, maxDepth,maxThreads, stop);
+	}
 
-		if (maxDepth == 0)
+
+	/**
+	* @brief returns the end of the natural run starting at begin. Strictly descending runs are reversed (stable)
+	**/
+	template <typename I, typename U>
+	I _extend_run(I begin, I end, U cmp)
+	{
+		I next = std::next(begin);
+		if (next == end)
+			return end;
+
+		if (cmp(*next, *begin))
 		{
-			heapsort(begin, end, cmp);
-			return;
+			while (++next != end && cmp(*next, *std::prev(next)))
+				;
+			inverse_order(begin, next);
+		}
+		else
+		{
+			while (++next != end && !cmp(*next, *std::prev(next)))
+				;
 		}
+		return next;
+	}
 
-		//median of three
-		I pivot = std::prev(end);
-		swap(*median_of_three(begin, std::next(begin, dist / 2), std::prev(end), cmp), *pivot);
 
-		//partition
-		I pivPos = sort::partition(begin, pivot, cmp);
-		//move pivot to correct position
-		swap(*pivPos, *pivot);
-		
-		if (maxThreads > 1)
+	/**
+	* @brief exponential search from the front. Returns the first position in [begin, end) for which pred is false (pred: true...true false...false)
+	**/
+	template <typename I, typename P>
+	I _gallop_forward(I begin, I end, P pred)
+	{
+		const auto size = std::distance(begin, end);
+		decltype(std::distance(begin, end)) lo = 0, hi = 1;
+		while (hi < size && pred(*std::next(begin, hi)))
 		{
-			std::future<void> f1 = std::async([&]() {_introsort(begin, pivPos, cmp, maxDepth - 1,maxThreads - 2); });
-			std::future<void> f2 = std::async([&]() {_introsort(std::next(pivPos), end, cmp, maxDepth - 1,maxThreads - 2); });
-			f1.get();
-			f2.get();
+			lo = hi;
+			hi = 2 * hi + 1;
+		}
+		if (hi > size)
+			hi = size;
+		return std::partition_point(std::next(begin, lo), std::next(begin, hi), pred);
+	}
+
+
+	/**
+	* @brief exponential search from the back. Returns the first position in [begin, end) from which on pred is true (pred: false...false true...true)
+	**/
+	template <typename I, typename P>
+	I _gallop_backward(I begin, I end, P pred)
+	{
+		const auto size = std::distance(begin, end);
+		decltype(std::distance(begin, end)) lo = 0, hi = 1;
+		while (hi <= size && pred(*std::prev(end, hi)))
+		{
+			lo = hi;
+			hi = 2 * hi + 1;
+		}
+		if (hi > size)
+			hi = size;
+		return std::partition_point(std::prev(end, hi), std::prev(end, lo), [&](const auto& value) { return !pred(value); });
+	}
+
+
+	static constexpr auto minGallopLength = 7;	//consecutive wins of one run before a merge switches to galloping
+
+	/**
+	* @brief merges [begin, mid) and [mid, end) from the front. The left run is moved to buffer (used if the left run is the shorter one)
+	**/
+	template <typename I, typename U, typename B>
+	void _merge_lo(I begin, I mid, I end, U cmp, B& buffer, int& minGallop)
+	{
+		using V = typename std::iterator_traits<I>::value_type;
+
+		buffer.clear();
+		std::move(begin, mid, std::back_inserter(buffer));
+		auto left = buffer.begin();
+		const auto leftEnd = buffer.end();
+		I right = mid, out = begin;
+		auto leftWins = 0, rightWins = 0;
+
+		while (left != leftEnd && right != end)
+		{
+			if (cmp(*right, *left))
+			{
+				*out = std::move(*right);
+				++right;
+				++rightWins;
+				leftWins = 0;
+			}
+			else
+			{
+				*out = std::move(*left);
+				++left;
+				++leftWins;
+				rightWins = 0;
+			}
+			++out;
+
+			//an exhausted run ends the merge, the gallop below would read past its end
+			if (left == leftEnd || right == end)
+				break;
+			if (leftWins < minGallop && rightWins < minGallop)
+				continue;
+
+			//galloping: move whole blocks as long as one run keeps winning
+			do
+			{
+				const auto leftBlockEnd = _gallop_forward(left, leftEnd, [&](const V& value) { return !cmp(*right, value); });
+				leftWins = static_cast<int>(std::distance(left, leftBlockEnd));
+				out = std::move(left, leftBlockEnd, out);
+				left = leftBlockEnd;
+				if (left == leftEnd)
+					break;
+
+				const I rightBlockEnd = _gallop_forward(right, end, [&](const auto& value) { return cmp(value, *left); });
+				rightWins = static_cast<int>(std::distance(right, rightBlockEnd));
+				out = std::move(right, rightBlockEnd, out);
+				right = rightBlockEnd;
+				if (right == end)
+					break;
+
+				if (minGallop > 1)
+					--minGallop;
+			} while (leftWins >= minGallopLength || rightWins >= minGallopLength);
+			minGallop += 2;	//leaving gallop mode is penalized
+			leftWins = rightWins = 0;
+		}
+		//the rest of the right run is already in place
+		std::move(left, leftEnd, out);
+	}
+
+
+	/**
+	* @brief merges [begin, mid) and [mid, end) from the back. The right run is moved to buffer (used if the right run is the shorter one)
+	**/
+	template <typename I, typename U, typename B>
+	void _merge_hi(I begin, I mid, I end, U cmp, B& buffer, int& minGallop)
+	{
+		using V = typename std::iterator_traits<I>::value_type;
+
+		buffer.clear();
+		std::move(mid, end, std::back_inserter(buffer));
+		const auto rightBegin = buffer.begin();
+		auto right = buffer.end();
+		I left = mid, out = end;
+		auto leftWins = 0, rightWins = 0;
+
+		while (left != begin && right != rightBegin)
+		{
+			if (cmp(*std::prev(right), *std::prev(left)))
+			{
+				*--out = std::move(*--left);
+				++leftWins;
+				rightWins = 0;
+			}
+			else
+			{
+				*--out = std::move(*--right);
+				++rightWins;
+				leftWins = 0;
+			}
+
+			//an exhausted run ends the merge, the gallop below would read before its begin
+			if (left == begin || right == rightBegin)
+				break;
+			if (leftWins < minGallop && rightWins < minGallop)
+				continue;
+
+			//galloping: move whole blocks as long as one run keeps winning
+			do
+			{
+				const I leftBlockBegin = _gallop_backward(begin, left, [&](const auto& value) { return cmp(*std::prev(right), value); });
+				leftWins = static_cast<int>(std::distance(leftBlockBegin, left));
+				out = std::move_backward(leftBlockBegin, left, out);
+				left = leftBlockBegin;
+				if (left == begin)
+					break;
+
+				const auto rightBlockBegin = _gallop_backward(rightBegin, right, [&](const V& value) { return !cmp(value, *std::prev(left)); });
+				rightWins = static_cast<int>(std::distance(rightBlockBegin, right));
+				out = std::move_backward(rightBlockBegin, right, out);
+				right = rightBlockBegin;
+				if (right == rightBegin)
+					break;
+
+				if (minGallop > 1)
+					--minGallop;
+			} while (leftWins >= minGallopLength || rightWins >= minGallopLength);
+			minGallop += 2;	//leaving gallop mode is penalized
+			leftWins = rightWins = 0;
 		}
+		//the rest of the left run is already in place
+		std::move_backward(rightBegin, right, out);
+	}
+
+
+	/**
+	* @brief stable merge of two adjacent sorted runs. Elements which are already in place are skipped with galloping
+	**/
+	template <typename I, typename U, typename B>
+	void _merge_runs(I begin, I mid, I end, U cmp, B& buffer, int& minGallop)
+	{
+		//elements of the left run which are <= the first element of the right run are in place
+		begin = _gallop_forward(begin, mid, [&](const auto& value) { return !cmp(*mid, value); });
+		if (begin == mid)
+			return;
+		//elements of the right run which are >= the last element of the left run are in place
+		const I lastLeft = std::prev(mid);
+		end = _gallop_backward(mid, end, [&](const auto& value) { return !cmp(value, *lastLeft); });
+		if (mid == end)
+			return;
+
+		if (std::distance(begin, mid) <= std::distance(mid, end))
+			_merge_lo(begin, mid, end, cmp, buffer, minGallop);
 		else
+			_merge_hi(begin, mid, end, cmp, buffer, minGallop);
+	}
+
+
+	/**
+	* @brief minimum run length for powersort (between 32 and 64, so that size / minRun is close to a power of 2)
+	**/
+	template <typename D>
+	D _min_run_length(D size)
+	{
+		D remainder = 0;
+		while (size >= 64)
 		{
-			_introsort(begin, pivPos, cmp, maxDepth - 1, 0);
-			_introsort(std::next(pivPos), end, cmp, maxDepth - 1, 0);
+			remainder |= size & 1;
+			size >>= 1;
 		}
+		return size + remainder;
+	}
 
-	
+
+	/**
+	* @brief powersort node power of the boundary between two adjacent runs [begin, begin + leftLength) and [.., + rightLength) in an array of size elements
+	**/
+	inline int _node_power(size_t begin, size_t leftLength, size_t rightLength, size_t size)
+	{
+		auto power = 0;
+		size_t a = 2 * begin + leftLength;	//2 * midpoint of the left run
+		size_t b = a + leftLength + rightLength;	//2 * midpoint of the right run
+		for (;;)
+		{
+			++power;
+			if (a >= size)
+			{
+				a -= size;
+				b -= size;
+			}
+			else if (b >= size)
+			{
+				break;
+			}
+			a <<= 1;
+			b <<= 1;
+		}
+		return power;
 	}
 
+
 	/**
-	* @brief introsort template
+	* @brief powersort template. Stable and run-adaptive mergesort (natural runs, powersort merge policy, galloping merges). O(n) for presorted data
 	* @param begin: iterator to the begin of the container
 	* @param end: iterator to the end of the container
 	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
-	* @param maxThreads: (optional) max. number of threads which can run this algorithm parallel. default: 0
 	* @return void
 	**/
 	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
-	void introsort(I begin, I end, U cmp = U(),int maxThreads = 0)
+	void powersort(I begin, I end, U cmp = U())
 	{
-		const auto dist = std::distance(begin, end);
-		const auto maxDepth = static_cast<int>(std::log2(static_cast<double>(dist)));
-		_introsort(begin, end, cmp, maxDepth,maxThreads);
+		using D = typename std::iterator_traits<I>::difference_type;
+		struct Run
+		{
+			I begin;
+			D length;
+			int power;	//node power of the boundary to the previous run
+		};
+
+		const auto size = std::distance(begin, end);
+		if (size < 2)
+			return;
+
+		const auto minRun = _min_run_length(size);
+		std::vector<Run> runs;
+		std::vector<typename std::iterator_traits<I>::value_type> buffer;
+		auto minGallop = minGallopLength;
+
+		auto mergeTopRuns = [&]()
+		{
+			const Run right = runs.back();
+			runs.pop_back();
+			Run& left = runs.back();
+			_merge_runs(left.begin, right.begin, std::next(right.begin, right.length), cmp, buffer, minGallop);
+			left.length += right.length;
+		};
+
+		for (I runBegin = begin; runBegin != end;)
+		{
+			I runEnd = _extend_run(runBegin, end, cmp);
+			//extend short runs to minRun with binary insertionsort
+			if (std::distance(runBegin, runEnd) < minRun)
+			{
+				I forcedEnd = std::distance(runBegin, end) < minRun ? end : std::next(runBegin, minRun);
+				_binary_insertionsort(runBegin, runEnd, forcedEnd, cmp);
+				runEnd = forcedEnd;
+			}
+
+			const auto length = std::distance(runBegin, runEnd);
+			auto power = 0;
+			if (!runs.empty())
+			{
+				const Run& top = runs.back();
+				power = _node_power(static_cast<size_t>(std::distance(begin, top.begin)), static_cast<size_t>(top.length),
+					static_cast<size_t>(length), static_cast<size_t>(size));
+				while (runs.size() > 1 && runs.back().power > power)
+					mergeTopRuns();
+			}
+			runs.push_back({ runBegin, length, power });
+			runBegin = runEnd;
+		}
+
+		while (runs.size() > 1)
+			mergeTopRuns();
+	}
+
+
+	/**
+	* @brief runs func(thread) for thread = 0..threads-1 concurrently. thread 0 runs on the calling thread
+	**/
+	template <typename F>
+	void _parallel_for(const int threads, F func)
+	{
+		std::vector<std::future<void>> workers;
+		for (auto t = 1; t < threads; ++t)
+			workers.push_back(std::async(std::launch::async, func, t));
+		func(0);
+		for (auto& worker : workers)
+			worker.get();
+	}
+
+
+	static constexpr auto samplesortMinBucketSize = 256;	//expected bucket size, decides the number of buckets
+	static constexpr auto samplesortMaxLogBuckets = 8;	//at most 256 buckets (bucket ids fit in one byte)
+	static constexpr auto samplesortOversampling = 16;	//samples per bucket for choosing the splitters
+
+	/**
+	* @brief samplesort template (parallel). Chooses splitters from an oversampled random sample, classifies all elements with a
+	* branchless search tree, scatters them into their buckets in parallel and sorts the buckets independently.
+	* If the sample contains duplicate splitters, every bucket gets an equality bucket for the elements equal to its upper splitter,
+	* these are already sorted. If all splitters are equal, introsort (three-way partitioning) sorts the whole range
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+	* @param maxThreads: number of worker threads. default = 0 (no multithreading)
+	* @param stop: (optional) token which stops the sort early
+	* @return void
+	**/
+	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
+	void samplesort(I begin, I end, U cmp = U(), const int maxThreads = 0, const StopToken stop = StopToken())
+	{
+		using V = typename std::iterator_traits<I>::value_type;
+
+		const auto size = static_cast<size_t>(std::distance(begin, end));
+		auto logBuckets = 0;
+		while (logBuckets < samplesortMaxLogBuckets && (size >> (logBuckets + 1)) >= samplesortMinBucketSize)
+			++logBuckets;
+		if (logBuckets == 0)
+		{
+			introsort(begin, end, cmp, 0, stop);
+			return;
+		}
+		const auto threads = static_cast<int>(std::min<size_t>(std::max(maxThreads, 1), size / samplesortMinBucketSize));
+
+		//oversampling. the splitters are evenly spaced elements of the sorted sample
+		std::vector<V> sample;
+		const auto sampleSize = static_cast<size_t>(samplesortOversampling) << logBuckets;
+		sample.reserve(sampleSize);
+		std::mt19937 gen(std::random_device{}());
+		std::uniform_int_distribution<size_t> dist(0, size - 1);
+		for (size_t i = 0; i < sampleSize; ++i)
+			sample.push_back(*std::next(begin, dist(gen)));
+		introsort(sample.begin(), sample.end(), cmp);
+
+		//duplicate splitters: equality buckets double the bucket ids, which have to fit in one byte
+		auto splitter = [&](const size_t rank) -> V& { return sample[rank * (sample.size() >> logBuckets) - 1]; };
+		if (logBuckets > 1 && !cmp(splitter(1), splitter((size_t(1) << logBuckets) - 1)))
+		{
+			introsort(begin, end, cmp, maxThreads, stop);
+			return;
+		}
+		auto equalBuckets = false;
+		for (size_t rank = 2; rank < (size_t(1) << logBuckets) && !equalBuckets; ++rank)
+			equalBuckets = !cmp(splitter(rank - 1), splitter(rank));
+		if (equalBuckets && logBuckets == samplesortMaxLogBuckets)
+			--logBuckets;
+		const size_t buckets = size_t(1) << logBuckets;
+		const size_t bucketIds = equalBuckets ? 2 * buckets : buckets;
+
+		//implicit search tree of the splitters (tree[1] is the root, children of node are 2 * node and 2 * node + 1)
+		std::vector<V> tree(buckets);
+		std::vector<size_t> upperNode(buckets, 0);	//node of the upper splitter of every bucket except the last one
+		for (size_t node = 1, level = 0; node < buckets; ++node)
+		{
+			if (node == (size_t(2) << level))
+				++level;
+			//in-order rank of the node in the perfect tree = index of its splitter
+			const auto rank = (2 * (node - (size_t(1) << level)) + 1) << (logBuckets - 1 - level);
+			tree[node] = std::move(splitter(rank));
+			upperNode[rank - 1] = node;
+		}
+
+		//classify: every level of the tree is one comparison without a data dependent branch
+		std::vector<std::uint8_t> bucketOf(size);
+		std::vector<std::vector<size_t>> counts(threads, std::vector<size_t>(bucketIds, 0));
+		const size_t chunk = (size + threads - 1) / threads;
+		_parallel_for(threads, [&](const int t)
+		{
+			const size_t first = std::min(size, t * chunk), last = std::min(size, first + chunk);
+			I it = std::next(begin, first);
+			for (size_t i = first; i != last; ++i, ++it)
+			{
+				size_t node = 1;
+				for (auto level = 0; level < logBuckets; ++level)
+					node = 2 * node + static_cast<size_t>(cmp(tree[node], *it));
+				auto id = node - buckets;
+				//elements of a bucket are <= its upper splitter, the equal ones go to the equality bucket
+				if (equalBuckets)
+					id = 2 * id + static_cast<size_t>(id + 1 < buckets && !cmp(*it, tree[upperNode[id]]));
+				bucketOf[i] = static_cast<std::uint8_t>(id);
+				++counts[t][id];
+			}
+		});
+
+		//exclusive prefix sum over (bucket, thread) gives every thread its own write position in every bucket
+		std::vector<size_t> bucketBegin(bucketIds + 1, 0);
+		auto offset = size_t(0);
+		for (size_t b = 0; b < bucketIds; ++b)
+		{
+			bucketBegin[b] = offset;
+			for (auto t = 0; t < threads; ++t)
+			{
+				const auto count = counts[t][b];
+				counts[t][b] = offset;
+				offset += count;
+			}
+		}
+		bucketBegin[bucketIds] = size;
+		if (stop.stop_requested())
+			return;
+
+		//scatter
+		std::vector<V> scattered(size);
+		_parallel_for(threads, [&](const int t)
+		{
+			const size_t first = std::min(size, t * chunk), last = std::min(size, first + chunk);
+			auto& position = counts[t];
+			I it = std::next(begin, first);
+			for (size_t i = first; i != last; ++i, ++it)
+				scattered[position[bucketOf[i]]++] = std::move(*it);
+		});
+
+		//move the buckets back and sort them independently. buckets are handed out dynamically, equality buckets are already sorted
+		std::atomic<size_t> nextBucket{ 0 };
+		_parallel_for(threads, [&](int)
+		{
+			for (auto b = nextBucket++; b < bucketIds; b = nextBucket++)
+			{
+				if (bucketBegin[b] == bucketBegin[b + 1])
+					continue;
+				I bucket = std::next(begin, bucketBegin[b]);
+				std::move(std::next(scattered.begin(), bucketBegin[b]), std::next(scattered.begin(), bucketBegin[b + 1]), bucket);
+				if (!equalBuckets || b % 2 == 0)
+					introsort(bucket, std::next(begin, bucketBegin[b + 1]), cmp, 0, stop);	//the bucket is moved back even if stopped
+			}
+		});
+	}
+
+
+	/**
+	* @brief sorted range [begin, end) as source of a LoserTree
+	**/
+	template <typename I>
+	struct MergeRange
+	{
+		I begin;
+		I end;
+
+		bool empty() const { return begin == end; }
+		typename std::iterator_traits<I>::reference front() const { return *begin; }
+		void next() { ++begin; }
+	};
+
+
+	/**
+	* @brief tournament tree of losers for merging k sorted sources in one pass (log2(k) comparisons per element).
+	* Source needs bool empty() const, front() const (current element) and void next(). Exhausted sources act as +infinity sentinel.
+	* Equal elements are taken from the source with the lower index first (stable)
+	**/
+	template <typename Source, typename U>
+	class LoserTree
+	{
+		std::vector<Source> mSources;
+		std::vector<size_t> mTree;	//mTree[0]: index of the winning source, mTree[1..k-1]: loser of the match at this node
+		U mCmp;
+
+		//true if source a wins against source b
+		bool wins(const size_t a, const size_t b) const
+		{
+			if (mSources[b].empty())
+				return true;
+			if (mSources[a].empty())
+				return false;
+			return a < b ? !mCmp(mSources[b].front(), mSources[a].front()) : mCmp(mSources[a].front(), mSources[b].front());
+		}
+
+	public:
+		/**
+		* @brief constructor. plays the initial tournament
+		* @param sources: sorted sources
+		* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+		**/
+		explicit LoserTree(std::vector<Source> sources, U cmp = U()) : mSources(std::move(sources)), mTree(std::max<size_t>(mSources.size(), 1), 0), mCmp(cmp)
+		{
+			//leaves are the nodes k..2k-1, node i has the children 2i and 2i+1
+			const auto k = mSources.size();
+			std::vector<size_t> winner(2 * k);
+			for (size_t i = 0; i < k; ++i)
+				winner[k + i] = i;
+			for (auto node = k - 1; k > 1 && node > 0; --node)
+			{
+				const auto a = winner[2 * node], b = winner[2 * node + 1];
+				const auto aWins = wins(a, b);
+				winner[node] = aWins ? a : b;
+				mTree[node] = aWins ? b : a;
+			}
+			mTree[0] = k > 1 ? winner[1] : 0;
+		}
+
+		/**
+		* @brief check if all sources are exhausted
+		* @return true if no element is left
+		**/
+		bool empty() const { return mSources.empty() || mSources[mTree[0]].empty(); }
+
+		/**
+		* @brief source which holds the smallest element (top().front()). tree must not be empty
+		* @return reference to the source
+		**/
+		Source& top() { return mSources[mTree[0]]; }
+
+		/**
+		* @brief removes the smallest element and replays the matches on the path of its source
+		* @return void
+		**/
+		void pop()
+		{
+			auto winner = mTree[0];
+			mSources[winner].next();
+			for (auto node = (winner + mSources.size()) / 2; node > 0; node /= 2)
+				if (wins(mTree[node], winner))
+					std::swap(mTree[node], winner);
+			mTree[0] = winner;
+		}
+	};
+
+
+	/**
+	* @brief k-way merge template. Moves the elements of all sorted runs to out in one pass using a LoserTree (stable)
+	* @param runs: sorted ranges (begin, end)
+	* @param out: output iterator
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+	* @return output iterator behind the last written element
+	**/
+	template <typename I, typename O, typename U = std::less<typename std::iterator_traits<I>::value_type> >
+	O multiway_merge(const std::vector<std::pair<I, I>>& runs, O out, U cmp = U())
+	{
+		std::vector<MergeRange<I>> sources;
+		sources.reserve(runs.size());
+		for (const auto& run : runs)
+			sources.push_back({ run.first, run.second });
+
+		for (LoserTree<MergeRange<I>, U> tree(std::move(sources), cmp); !tree.empty(); tree.pop())
+		{
+			*out = std::move(tree.top().front());
+			++out;
+		}
+		return out;
+	}
+
+
+	/**
+	* @brief multiway mergesort template (optional multithreading). Sorts one chunk per thread with powersort and merges all chunks in a single k-way merge (stable)
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b.
+	* @param maxThreads: number of threads. default = 0 (no multithreading)
+	* @param stop: (optional) token which stops the sort early
+	* @return void
+	**/
+	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
+	void multiway_mergesort(I begin, I end, U cmp = U(), const int maxThreads = 0, const StopToken stop = StopToken())
+	{
+		const auto size = std::distance(begin, end);
+		if (size < 2)
+			return;
+
+		//one chunk per thread, at least 2 chunks with at least leafSortThreshold elements each
+		const auto threads = std::max(maxThreads, 1);
+		const auto chunks = static_cast<int>(std::max<decltype(size)>(1, std::min<decltype(size)>(std::max(threads, 2), size / leafSortThreshold)));
+		std::vector<std::pair<I, I>> runs;
+		for (auto c = 0; c < chunks; ++c)
+			runs.emplace_back(std::next(begin, size * c / chunks), std::next(begin, size * (c + 1) / chunks));
+
+		const auto workers = std::min(threads, chunks);
+		_parallel_for(workers, [&](const int t)
+		{
+			for (auto c = t; c < chunks && !stop.stop_requested(); c += workers)
+				powersort(runs[c].first, runs[c].second, cmp);
+		});
+		if (stop.stop_requested())
+			return;
+
+		std::vector<typename std::iterator_traits<I>::value_type> merged;
+		merged.reserve(static_cast<size_t>(size));
+		multiway_merge(runs, std::back_inserter(merged), cmp);
+		std::move(merged.begin(), merged.end(), begin);
+	}
+
+
+	static constexpr size_t countingsortMinRange = 1 << 16;	//key ranges up to max(size, countingsortMinRange) are counted, wider ranges are merge sorted
+
+
+	/**
+	* @brief counting sort template (optional multithreading) for dense key domains. A prepass finds the range of the radix keys, every thread counts the keys
+	* of its chunk in its own histogram and the prefix sum over (key, thread) gives every thread its write positions. Integers are written from the counts
+	* in one pass, other elements are scattered to a buffer and moved back. Ranges wider than max(size, countingsortMinRange) are sorted with multiway_mergesort (stable)
+	* @param begin: iterator to the begin of the container
+	* @param end: iterator to the end of the container
+	* @param cmp: (optional) compare function (bool cmp(const X &a,const X &b);) which returns true if a < b. has to be consistent with the order of radix_key
+	* @param maxThreads: number of threads. default = 0 (no multithreading)
+	* @param stop: (optional) token which stops the sort early
+	* @param scratch: (optional) arena for the scatter buffer, a temporary one is used if nullptr
+	* @return void
+	* @note radix_key has to support the value type (integers, floating point numbers or bitwise '&' operator)
+	**/
+	template <typename I, typename U = std::less<typename std::iterator_traits<I>::value_type> >
+	void countingsort(I begin, I end, U cmp = U(), const int maxThreads = 0, const StopToken stop = StopToken(), ScratchArena* scratch = nullptr)
+	{
+		using V = typename std::iterator_traits<I>::value_type;
+
+		const auto size = static_cast<size_t>(std::distance(begin, end));
+		if (size < 2 || stop.stop_requested())
+			return;
+		const auto range = radix_minmax(begin, end, maxThreads);
+		if (static_cast<std::uint64_t>(range.second - range.first) >= std::max<std::uint64_t>(size, countingsortMinRange))
+		{
+			multiway_mergesort(begin, end, cmp, maxThreads, stop);
+			return;
+		}
+		const auto keys = static_cast<size_t>(range.second - range.first) + 1;
+
+		//one histogram per thread, all histograms together use at most half as many counters as there are elements
+		const auto threads = static_cast<int>(std::max<size_t>(1, std::min<size_t>(std::max(maxThreads, 1), size / (2 * keys))));
+		std::vector<std::vector<size_t>> counts(threads, std::vector<size_t>(keys, 0));
+		const size_t chunk = (size + threads - 1) / threads;
+		_parallel_for(threads, [&](const int t)
+		{
+			const size_t first = std::min(size, t * chunk), last = std::min(size, first + chunk);
+			auto& count = counts[t];
+			I it = std::next(begin, first);
+			for (size_t i = first; i != last; ++i, ++it)
+				++count[radix_key(*it) - range.first];
+		});
+
+		//exclusive prefix sum over (key, thread) gives every thread its own write position for every key
+		auto offset = size_t(0);
+		for (size_t k = 0; k < keys; ++k)
+		{
+			for (auto t = 0; t < threads; ++t)
+			{
+				const auto count = counts[t][k];
+				counts[t][k] = offset;
+				offset += count;
+			}
+		}
+		if (stop.stop_requested())
+			return;
+
+		if constexpr (std::is_integral_v<V>)
+		{
+			//the value of a key is known, so every thread writes the runs of its keys directly
+			const auto& keyBegin = counts[0];
+			_parallel_for(threads, [&](const int t)
+			{
+				const size_t first = keys * t / threads, last = keys * (t + 1) / threads;
+				for (auto k = first; k != last; ++k)
+				{
+					using K = decltype(range.first);
+					const auto key = static_cast<K>(range.first + k);
+					const auto value = static_cast<V>(std::is_signed_v<V> ? key ^ (K(1) << (sizeof(K) * 8 - 1)) : key);
+					const auto runEnd = k + 1 < keys ? keyBegin[k + 1] : size;
+					std::fill(std::next(begin, keyBegin[k]), std::next(begin, runEnd), value);
+				}
+			});
+		}
+		else
+		{
+			//stable scatter to the final positions and move back. every position of the buffer is constructed once
+			ScratchArena temporary;
+			V* scattered = (scratch ? *scratch : temporary).template acquire<V>(size);
+			_parallel_for(threads, [&](const int t)
+			{
+				const size_t first = std::min(size, t * chunk), last = std::min(size, first + chunk);
+				auto& position = counts[t];
+				I it = std::next(begin, first);
+				for (size_t i = first; i != last; ++i, ++it)
+					::new (static_cast<void*>(scattered + position[radix_key(*it) - range.first]++)) V(std::move(*it));
+			});
+			_parallel_for(threads, [&](const int t)
+			{
+				const size_t first = std::min(size, t * chunk), last = std::min(size, first + chunk);
+				std::move(scattered + first, scattered + last, std::next(begin, first));
+				std::destroy(scattered + first, scattered + last);
+			});
+		}
 	}
 }